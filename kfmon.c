@@ -86,91 +86,1403 @@ static int
 	// Redirect stderr to our logfile
 	// NOTE: We do need O_APPEND (as opposed to simply calling lseek(fd, 0, SEEK_END) after open),
 	//       because auxiliary scripts *may* also append to this log file ;).
-	int         flags = O_WRONLY | O_CREAT | O_APPEND;
-	// Check if we need to truncate our log because it has grown too much...
+	// NOTE: We used to truncate it here if it had grown over 1MB, it's now rotated as it grows (c.f., log_rotate).
+	if ((fd = open(KFMON_LOGFILE, O_WRONLY | O_CREAT | O_APPEND, S_IRUSR | S_IWUSR)) != -1) {
+		dup2(fd, fileno(stderr));
+		if (fd > 2 + 3) {
+			close(fd);
+		}
+	} else {
+		PFLOG(LOG_CRIT, "Failed to redirect stderr to logfile '%s' (open: %m)", KFMON_LOGFILE);
+		return -1;
+	}
+
+	return 0;
+}
+
+// Wrapper around localtime_r, making sure this part is thread-safe (used for logging)
+static struct tm*
+    get_localtime(time_t t, struct tm* restrict lt)
+{
+	tzset();
+
+	return localtime_r(&t, lt);
+}
+
+// Wrapper around strftime, making sure this part is thread-safe (used for logging)
+static char*
+    format_localtime(struct tm* restrict lt, char* restrict sz_time, size_t len)
+{
+	// c.f., strftime(3) & https://stackoverflow.com/questions/7411301
+	strftime(sz_time, len, "%Y-%m-%d @ %H:%M:%S", lt);
+
+	return sz_time;
+}
+
+// Return t formatted as 2016-04-29 @ 20:44:13, only doing the actual work when the second changes.
+// NOTE: Thread-safe as long as each thread uses its own cache.
+static const char*
+    format_timestamp(TimeStampCache* restrict cache, time_t t)
+{
+	if (t != cache->t || cache->sz_time[0] == '\0') {
+		struct tm local_tm;
+		format_localtime(get_localtime(t, &local_tm), cache->sz_time, sizeof(cache->sz_time));
+		cache->t = t;
+	}
+
+	return cache->sz_time;
+}
+
+static const char*
+    get_log_prefix(int prio)
+{
+	// Reuse (part of) the syslog() priority constants
+	switch (prio) {
+		case LOG_CRIT:
+			return "CRIT";
+		case LOG_ERR:
+			return "ERR!";
+		case LOG_WARNING:
+			return "WARN";
+		case LOG_NOTICE:
+			return "NOTE";
+		case LOG_INFO:
+			return "INFO";
+		case LOG_DEBUG:
+			return "DBG!";
+		default:
+			return "OOPS";
+	}
+}
+
+// Setup our log ring. Has to run before anything is logged.
+static void
+    log_init(void)
+{
+	for (uint32_t i = 0U; i < LOG_RING_SLOTS; i++) {
+		logRing.slots[i].seq = i;
+	}
+
+	// Make sure whatever's still in the ring makes it to disk when we exit
+	atexit(log_final_flush);
+}
+
+// Format a log line into the ring (c.f., LOG)
+static void
+    log_enqueue(const char* restrict tag, int prio, const char* restrict fmt, ...)
+{
+	// Make sure we don't clobber errno, as our callers may rely on it after logging
+	int saved_errno = errno;
+
+	// Claim a slot
+	uint32_t pos = __atomic_load_n(&logRing.head, __ATOMIC_RELAXED);
+	LogSlot* slot;
+	for (;;) {
+		slot         = &logRing.slots[pos & (LOG_RING_SLOTS - 1U)];
+		uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		int32_t  dif = (int32_t) (seq - pos);
+		if (dif == 0) {
+			if (__atomic_compare_exchange_n(
+				&logRing.head, &pos, pos + 1U, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (dif < 0) {
+			// The ring is full, we'll have to drop it (log_flush will mention it).
+			__atomic_add_fetch(&logRing.dropped, 1U, __ATOMIC_RELAXED);
+			log_wakeup();
+			errno = saved_errno;
+			return;
+		} else {
+			// Another producer beat us to it, try again
+			pos = __atomic_load_n(&logRing.head, __ATOMIC_RELAXED);
+		}
+	}
+
+	// NOTE: %m is handled by vsnprintf, hence the need to leave errno alone until now.
+	slot->prio = prio;
+	slot->ts   = time(NULL);
+	slot->tag  = tag;
+	va_list ap;
+	va_start(ap, fmt);
+	int len = vsnprintf(slot->msg, sizeof(slot->msg), fmt, ap);
+	va_end(ap);
+	slot->len = len < 0 ? 0U : MIN((size_t) len, sizeof(slot->msg) - 1U);
+	// Publish it
+	__atomic_store_n(&slot->seq, pos + 1U, __ATOMIC_SEQ_CST);
+
+	uint32_t pending = pos - __atomic_load_n(&logRing.tail, __ATOMIC_SEQ_CST);
+	if (!__atomic_load_n(&logRing.is_running, __ATOMIC_ACQUIRE)) {
+		// Nobody's there to flush it for us yet, so do it ourselves if it's filling up.
+		// NOTE: Otherwise, we wait until we know where our log should go (c.f., start_log_thread),
+		//       and we'll be flushed at exit if we never get that far.
+		if (pending >= LOG_RING_SLOTS / 2U) {
+			log_flush();
+		}
+	} else {
+		// Let the logger thread know that there's something to flush (if the ring was empty),
+		// or that it shouldn't wait to flush it (if it's urgent, or if the ring is filling up).
+		if (pending == 0U || pending == LOG_RING_SLOTS / 2U || prio <= LOG_ERR || daemonConfig.log_flush == 0U) {
+			log_wakeup();
+		}
+	}
+
+	errno = saved_errno;
+}
+
+static void
+    log_wakeup(void)
+{
+	if (logRing.efd != -1) {
+		eventfd_write(logRing.efd, 1U);
+	}
+}
+
+// Drain the ring to disk
+static void
+    log_flush(void)
+{
+	pthread_mutex_lock(&loglock);
+	// NOTE: Only ever used with loglock held, so we can afford static storage.
+	static char           buf[LOG_FLUSH_SZ];
+	static TimeStampCache cache = { 0 };
+	size_t                used  = 0U;
+
+	uint32_t pos = logRing.tail;
+	for (;;) {
+		LogSlot* slot = &logRing.slots[pos & (LOG_RING_SLOTS - 1U)];
+		if (__atomic_load_n(&slot->seq, __ATOMIC_SEQ_CST) != pos + 1U) {
+			// Empty, or still being written to
+			break;
+		}
+
+		// Make room if need be (a line can't be larger than a slot + our prefix, + a possible repeat summary)
+		if (sizeof(buf) - used < LOG_LINE_MAX + 192U) {
+			log_write(buf, used);
+			used = 0U;
+		}
+		if (slot->len == logRepeat.len && slot->prio == logRepeat.prio && slot->tag == logRepeat.tag &&
+		    slot->ts - logRepeat.first_ts < LOG_REPEAT_WINDOW &&
+		    memcmp(slot->msg, logRepeat.msg, slot->len) == 0) {
+			// Same as the previous one, just count it
+			logRepeat.count++;
+			logRepeat.last_ts = slot->ts;
+		} else {
+			used += log_format_repeats(buf + used, sizeof(buf) - used, &cache);
+			int len = snprintf(buf + used,
+					   sizeof(buf) - used,
+					   "[%s] [%s] [%s] %.*s\n",
+					   slot->tag,
+					   format_timestamp(&cache, slot->ts),
+					   get_log_prefix(slot->prio),
+					   (int) slot->len,
+					   slot->msg);
+			if (len > 0) {
+				used += MIN((size_t) len, sizeof(buf) - used - 1U);
+			}
+
+			// Remember it, to catch repeats
+			logRepeat.first_ts = slot->ts;
+			logRepeat.last_ts  = slot->ts;
+			logRepeat.tag      = slot->tag;
+			logRepeat.len      = slot->len;
+			logRepeat.prio     = slot->prio;
+			memcpy(logRepeat.msg, slot->msg, slot->len);
+		}
+
+		// Hand the slot back to the producers
+		__atomic_store_n(&slot->seq, pos + LOG_RING_SLOTS, __ATOMIC_RELEASE);
+		pos++;
+		__atomic_store_n(&logRing.tail, pos, __ATOMIC_SEQ_CST);
+	}
+
+	// Don't sit on repeats for too long
+	if (logRepeat.count > 0U && time(NULL) - logRepeat.first_ts >= LOG_REPEAT_WINDOW) {
+		used += log_format_repeats(buf + used, sizeof(buf) - used, &cache);
+		// Start afresh, so that the next one actually makes it to the log
+		logRepeat.len = 0U;
+	}
+
+	uint32_t dropped = __atomic_exchange_n(&logRing.dropped, 0U, __ATOMIC_RELAXED);
+	if (dropped > 0U) {
+		int len = snprintf(buf + used,
+				   sizeof(buf) - used,
+				   "[KFMon] [%s] [WARN] Dropped %u log messages, as the log ring was full!\n",
+				   format_timestamp(&cache, time(NULL)),
+				   dropped);
+		if (len > 0) {
+			used += MIN((size_t) len, sizeof(buf) - used - 1U);
+		}
+	}
+
+	if (used > 0U) {
+		log_write(buf, used);
+		log_rotate_if_needed();
+	}
+	reap_log_compressor(false);
+	pthread_mutex_unlock(&loglock);
+}
+
+// Format the "last message repeated N times" line for the repeats we've swallowed so far, if any.
+// Returns the amount of bytes written to buf.
+// NOTE: Called with loglock held.
+static size_t
+    log_format_repeats(char* buf, size_t size, TimeStampCache* cache)
+{
+	if (logRepeat.count == 0U) {
+		return 0U;
+	}
+
+	int len = snprintf(buf,
+			   size,
+			   "[%s] [%s] [%s] last message repeated %u time%s\n",
+			   logRepeat.tag,
+			   format_timestamp(cache, logRepeat.last_ts),
+			   get_log_prefix(logRepeat.prio),
+			   logRepeat.count,
+			   logRepeat.count > 1U ? "s" : "");
+	__atomic_store_n(&logRepeat.count, 0U, __ATOMIC_RELAXED);
+	return len > 0 ? MIN((size_t) len, size - 1U) : 0U;
+}
+
+// Flush everything on our way out, including the repeats we were still sitting on
+static void
+    log_final_flush(void)
+{
+	log_flush();
+
+	pthread_mutex_lock(&loglock);
+	char                  buf[256];
+	static TimeStampCache cache = { 0 };
+	size_t                len   = log_format_repeats(buf, sizeof(buf), &cache);
+	if (len > 0U) {
+		log_write(buf, len);
+	}
+	pthread_mutex_unlock(&loglock);
+}
+
+// Send a batch of log lines where they belong
+// NOTE: Called with loglock held.
+static void
+    log_write(const char* data, size_t len)
+{
+	if (daemonConfig.log_to_ram) {
+		ramlog_append(data, len);
+	} else {
+		write_in_full(fileno(stderr), data, len);
+	}
+}
+
+// NOTE: Called with loglock held.
+static void
+    ramlog_append(const char* data, size_t len)
+{
+	// Only the tail end of a huge write could survive anyway
+	if (len > LOG_RAM_SZ) {
+		data += len - LOG_RAM_SZ;
+		len = LOG_RAM_SZ;
+	}
+
+	size_t offset = ramLog.head % LOG_RAM_SZ;
+	size_t chunk  = MIN(len, LOG_RAM_SZ - offset);
+	memcpy(ramLog.data + offset, data, chunk);
+	memcpy(ramLog.data, data + chunk, len - chunk);
+	ramLog.head += len;
+}
+
+// Copy (at most) the last lines lines (0 for as many as possible) of our in-memory log to buf, oldest first.
+// Returns the amount of bytes copied.
+// NOTE: Called with loglock held.
+static size_t
+    ramlog_tail(char* buf, size_t size, unsigned int lines)
+{
+	size_t avail = MIN(ramLog.head, (size_t) LOG_RAM_SZ);
+	avail        = MIN(avail, size);
+
+	// Walk back from the end, counting LFs (the final one terminates the last line, so it doesn't count)
+	size_t       len   = 0U;
+	unsigned int count = 0U;
+	while (len < avail) {
+		char c = ramLog.data[(ramLog.head - len - 1U) % LOG_RAM_SZ];
+		if (c == '\n' && len > 0U) {
+			if (lines > 0U && ++count == lines) {
+				break;
+			}
+		}
+		len++;
+	}
+	// If we ran out of room, don't start in the middle of a line
+	if (len == avail && avail < ramLog.head) {
+		while (len > 0U && ramLog.data[(ramLog.head - len) % LOG_RAM_SZ] != '\n') {
+			len--;
+		}
+		if (len > 0U) {
+			// Skip the LF itself
+			len--;
+		}
+	}
+
+	size_t start = (ramLog.head - len) % LOG_RAM_SZ;
+	size_t chunk = MIN(len, LOG_RAM_SZ - start);
+	memcpy(buf, ramLog.data + start, chunk);
+	memcpy(buf + chunk, ramLog.data, len - chunk);
+	return len;
+}
+
+// Write our in-memory log to the userstore
+static int
+    log_save_ram(const char* reason)
+{
+	char* data = malloc(LOG_RAM_SZ);
+	if (!data) {
+		PFLOG(LOG_WARNING, "malloc: %m");
+		return -1;
+	}
+
+	int fd =
+	    open(KFMON_LOG_RAMDUMP, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd == -1) {
+		PFLOG(LOG_WARNING, "open: %m");
+		free(data);
+		return -1;
+	}
+
+	// Make sure everything we've got is in there
+	log_flush();
+	pthread_mutex_lock(&loglock);
+	size_t len = ramlog_tail(data, LOG_RAM_SZ, 0U);
+	pthread_mutex_unlock(&loglock);
+
+	char    footer[128];
+	int     footer_len = snprintf(footer, sizeof(footer), "**** Log saved %s ****\n", reason);
+	ssize_t ret        = write_in_full(fd, data, len);
+	if (ret >= 0) {
+		ret = write_in_full(fd, footer, (size_t) footer_len);
+	}
+	free(data);
+	if (ret < 0) {
+		PFLOG(LOG_WARNING, "write: %m");
+		close(fd);
+		return -1;
+	}
+	close(fd);
+
+	LOG(LOG_NOTICE, "Saved our in-memory log to '%s'", KFMON_LOG_RAMDUMP);
+	return EXIT_SUCCESS;
+}
+
+// Point stderr to a pipe we drain into our in-memory log, so that nothing we (or our libraries) print hits the disk.
+static void
+    capture_stderr(void)
+{
+	int fds[2];
+	if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) == -1) {
+		PFLOG(LOG_WARNING, "pipe2: %m");
+		return;
+	}
+	// NOTE: Our children get our original stderr back (c.f., spawn), so they won't end up in there.
+	dup2(fds[1], fileno(stderr));
+	close(fds[1]);
+	ramLog.pipe_fd = fds[0];
+}
+
+// Move whatever was written to stderr to our in-memory log
+static void
+    drain_stderr_capture(void)
+{
+	char    buf[PIPE_BUF];
+	ssize_t len;
+	while ((len = read(ramLog.pipe_fd, buf, sizeof(buf))) > 0) {    // Flawfinder: ignore
+		pthread_mutex_lock(&loglock);
+		ramlog_append(buf, (size_t) len);
+		pthread_mutex_unlock(&loglock);
+	}
+}
+
+// Last ditch effort to save what we can of the log if we crash.
+// NOTE: Signal handler, so, only async-signal-safe stuff in here!
+//       Which means no locking, so, this is best effort: a line being flushed concurrently might be mangled.
+static void
+    log_crash_handler(int signum)
+{
+	int fd = fileno(stderr);
+	if (daemonConfig.log_to_ram) {
+		fd = open(
+		    KFMON_LOG_RAMDUMP, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+		if (fd != -1) {
+			size_t len   = MIN(ramLog.head, (size_t) LOG_RAM_SZ);
+			size_t start = (ramLog.head - len) % LOG_RAM_SZ;
+			size_t chunk = MIN(len, LOG_RAM_SZ - start);
+			write_in_full(fd, ramLog.data + start, chunk);
+			write_in_full(fd, ramLog.data, len - chunk);
+		}
+	}
+
+	if (fd != -1) {
+		// What's still in the ring, without timestamps (localtime_r isn't async-signal-safe)
+		uint32_t head = __atomic_load_n(&logRing.head, __ATOMIC_ACQUIRE);
+		for (uint32_t pos = __atomic_load_n(&logRing.tail, __ATOMIC_ACQUIRE); pos != head; pos++) {
+			const LogSlot* slot = &logRing.slots[pos & (LOG_RING_SLOTS - 1U)];
+			if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1U) {
+				continue;
+			}
+			const char* prefix = get_log_prefix(slot->prio);
+			write_in_full(fd, "[KFMon] [crash] [", 17U);
+			write_in_full(fd, prefix, strlen(prefix));
+			write_in_full(fd, "] ", 2U);
+			write_in_full(fd, slot->msg, slot->len);
+			write_in_full(fd, "\n", 1U);
+		}
+
+		// And why we're going down
+		char  msg[]  = "[KFMon] [crash] [CRIT] Caught signal 00, aborting!\n";
+		char* digits = strchr(msg, '0');
+		digits[0]    = (char) ('0' + (signum / 10) % 10);
+		digits[1]    = (char) ('0' + signum % 10);
+		write_in_full(fd, msg, sizeof(msg) - 1U);
+
+		if (daemonConfig.log_to_ram) {
+			close(fd);
+		}
+	}
+
+	// SA_RESETHAND restored the default disposition, so this will take us down for real once we return.
+	raise(signum);
+}
+
+// Reap our background gzip job, if it's done (or wait for it to be)
+// NOTE: Called with loglock held, so, no logging in here!
+static void
+    reap_log_compressor(bool wait)
+{
+	if (logRing.gzip_pid <= 0) {
+		return;
+	}
+
+	int   wstatus;
+	pid_t ret;
+	do {
+		ret = waitpid(logRing.gzip_pid, &wstatus, wait ? 0 : WNOHANG);
+	} while (ret == -1 && errno == EINTR);
+	if (ret != 0) {
+		logRing.gzip_pid = 0;
+	}
+}
+
+// Rotate our log: kfmon.log becomes kfmon.log.1 (optionally compressed in the background), kfmon.log.1 becomes
+// kfmon.log.2, and so on, until the oldest segment falls off.
+// NOTE: Called with loglock held, so, no logging in here!
+//       Auxiliary scripts that still have the previous segment open will simply keep appending to it.
+static void
+    log_rotate(void)
+{
+	// Don't pull the rug from under a gzip job that's still running
+	reap_log_compressor(true);
+
+	unsigned int segments = daemonConfig.log_segments > 0U ? daemonConfig.log_segments : LOG_SEGMENTS_DEFAULT;
+	segments              = MIN(segments, LOG_SEGMENTS_MAX);
+	char src[KFMON_PATH_MAX];
+	char dst[KFMON_PATH_MAX];
+	if (segments > 1U) {
+		// Drop the oldest segment...
+		for (uint8_t gz = 0U; gz < 2U; gz++) {
+			snprintf(dst, sizeof(dst), "%s.%u%s", KFMON_LOGFILE, segments - 1U, gz ? ".gz" : "");
+			unlink(dst);
+		}
+		// ...shift the others...
+		for (unsigned int i = segments - 2U; i > 0U; i--) {
+			for (uint8_t gz = 0U; gz < 2U; gz++) {
+				snprintf(src, sizeof(src), "%s.%u%s", KFMON_LOGFILE, i, gz ? ".gz" : "");
+				snprintf(dst, sizeof(dst), "%s.%u%s", KFMON_LOGFILE, i + 1U, gz ? ".gz" : "");
+				rename(src, dst);
+			}
+		}
+		// ...and close the current one.
+		snprintf(dst, sizeof(dst), "%s.1", KFMON_LOGFILE);
+		if (rename(KFMON_LOGFILE, dst) == -1) {
+			return;
+		}
+	}
+
+	// Start a fresh segment (or truncate the only one we keep)
+	int flags = O_WRONLY | O_CREAT | O_APPEND;
+	if (segments <= 1U) {
+		flags |= O_TRUNC;
+	}
+	int fd = open(KFMON_LOGFILE, flags, S_IRUSR | S_IWUSR);
+	if (fd == -1) {
+		return;
+	}
+	dup2(fd, fileno(stderr));
+	if (fd > 2 + 3) {
+		close(fd);
+	}
+
+	// And compress the previous one in the background
+	if (segments > 1U && daemonConfig.log_compress) {
+		char        gzip_bin[]  = "gzip";
+		char        gzip_flag[] = "-f";
+		char* const argv[]      = { gzip_bin, gzip_flag, dst, NULL };
+		pid_t       pid;
+		// NOTE: We're (usually) on the logger thread, which blocks all signals, don't let gzip inherit that.
+		posix_spawnattr_t attr;
+		posix_spawnattr_init(&attr);
+		sigset_t mask;
+		sigemptyset(&mask);
+		posix_spawnattr_setsigmask(&attr, &mask);
+		posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+		if (posix_spawnp(&pid, gzip_bin, NULL, &attr, argv, environ) == 0) {
+			logRing.gzip_pid = pid;
+		}
+		posix_spawnattr_destroy(&attr);
+	}
+}
+
+// Rotate our log once it has outgrown its segment size
+static void
+    log_rotate_if_needed(void)
+{
 	struct stat st;
-	if ((stat(KFMON_LOGFILE, &st) == 0) && (S_ISREG(st.st_mode))) {
-		// Truncate if > 1MB
-		if (st.st_size > 1 * 1024 * 1024) {
-			flags |= O_TRUNC;
+	if (fstat(fileno(stderr), &st) == -1 || !S_ISREG(st.st_mode)) {
+		return;
+	}
+
+	unsigned int segment_kb =
+	    daemonConfig.log_segment_size > 0U ? daemonConfig.log_segment_size : LOG_SEGMENT_SIZE_DEFAULT;
+	if (st.st_size >= (off_t) segment_kb * 1024) {
+		log_rotate();
+	}
+}
+
+// Wait for a wakeup from the producers, for at most timeout ms (-1 for forever). Returns true if we were woken up.
+// NOTE: Also takes care of our stderr capture, if any.
+static bool
+    log_wait(int timeout)
+{
+	// NOTE: poll ignores negative fds, so the capture's pollfd is harmless if it's not setup.
+	struct pollfd pfds[2] = {
+		{     .fd = logRing.efd, .events = POLLIN },
+		{ .fd = ramLog.pipe_fd, .events = POLLIN },
+	};
+	int ret = poll(pfds, 2, timeout);
+	if (ret <= 0) {
+		return false;
+	}
+
+	if (pfds[1].revents & POLLIN) {
+		drain_stderr_capture();
+	}
+	if (pfds[0].revents & POLLIN) {
+		eventfd_t val;
+		eventfd_read(logRing.efd, &val);
+	}
+	return true;
+}
+
+// Flush the log ring in batches (runs in a dedicated thread)
+static void*
+    log_thread(void* ptr __attribute__((unused)))
+{
+	// Leave signals to the main thread
+	sigset_t mask;
+	sigfillset(&mask);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+	while (1) {
+		// Sleep until there's something to flush
+		// (or until our gzip job is likely done, so we can reap it, or until we can report on repeats)...
+		bool is_pending = __atomic_load_n(&logRing.gzip_pid, __ATOMIC_RELAXED) > 0 ||
+				  __atomic_load_n(&logRepeat.count, __ATOMIC_RELAXED) > 0U;
+		log_wait(is_pending ? 1000 : -1);
+		// ...and give a chance to a few more lines to pile up, unless something urgent comes in.
+		int signum = __atomic_load_n(&logRing.term_sig, __ATOMIC_ACQUIRE);
+		if (daemonConfig.log_flush > 0U && signum == 0) {
+			log_wait(daemonConfig.log_flush);
 		}
+		log_flush();
+		// Our event journal's batch rides along
+		journal_flush();
+
+		// We were asked to quit, now that our log is safe (repeats included), do it for real.
+		signum = __atomic_load_n(&logRing.term_sig, __ATOMIC_ACQUIRE);
+		if (signum != 0) {
+			log_final_flush();
+			struct sigaction sa = { .sa_handler = SIG_DFL };
+			sigaction(signum, &sa, NULL);
+			kill(getpid(), signum);
+		}
+	}
+
+	return (void*) NULL;
+}
+
+// Let the logger thread flush the ring before we die (it'll take care of re-raising the signal)
+static void
+    log_term_handler(int signum)
+{
+	__atomic_store_n(&logRing.term_sig, signum, __ATOMIC_RELEASE);
+	log_wakeup();
+}
+
+// Hand logging over to a dedicated thread (there's no need for one with syslog)
+static void
+    start_log_thread(void)
+{
+	if (daemonConfig.log_to_ram) {
+		capture_stderr();
+	}
+
+	logRing.efd = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (logRing.efd == -1) {
+		PFLOG(LOG_WARNING, "Logging synchronously (eventfd: %m)");
+		return;
+	}
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	// NOTE: We don't need much, log_flush's buffer is static.
+	pthread_attr_setstacksize(&attr, MAX((size_t) PTHREAD_STACK_MIN, 64U * 1024U));
+	pthread_t lthread;
+	if (pthread_create(&lthread, &attr, log_thread, NULL) != 0) {
+		pthread_attr_destroy(&attr);
+		PFLOG(LOG_WARNING, "Logging synchronously (pthread_create: %m)");
+		close(logRing.efd);
+		logRing.efd = -1;
+		return;
+	}
+	pthread_attr_destroy(&attr);
+	pthread_setname_np(lthread, "Logger");
+
+	__atomic_store_n(&logRing.is_running, true, __ATOMIC_RELEASE);
+	// Flush what piled up until now
+	log_wakeup();
+
+	// Don't lose the last few lines if we're killed...
+	struct sigaction sa = { .sa_handler = log_term_handler, .sa_flags = SA_RESTART };
+	sigaction(SIGTERM, &sa, NULL);
+	sigaction(SIGINT, &sa, NULL);
+	// ...or if we crash.
+	struct sigaction crash_sa = { .sa_handler = log_crash_handler, .sa_flags = (int) SA_RESETHAND };
+	sigaction(SIGSEGV, &crash_sa, NULL);
+	sigaction(SIGBUS, &crash_sa, NULL);
+	sigaction(SIGILL, &crash_sa, NULL);
+	sigaction(SIGFPE, &crash_sa, NULL);
+	sigaction(SIGABRT, &crash_sa, NULL);
+}
+
+// Start recording launch trace spans (from scratch)
+static int
+    trace_enable(void)
+{
+	pthread_mutex_lock(&tracelock);
+	if (launchTrace.enabled) {
+		pthread_mutex_unlock(&tracelock);
+		return EXIT_SUCCESS;
+	}
+
+	launchTrace.fd = open(KFMON_TRACEFILE, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+	if (launchTrace.fd == -1) {
+		pthread_mutex_unlock(&tracelock);
+		PFLOG(LOG_WARNING, "open: %m");
+		return -1;
+	}
+	// NOTE: The closing bracket is optional in the JSON Array Format, which is what makes appending possible ;).
+	launchTrace.size = write_in_full(launchTrace.fd, "[\n", 2U) == 2 ? 2U : 0U;
+	__atomic_store_n(&launchTrace.enabled, true, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&tracelock);
+
+	LOG(LOG_NOTICE, "Recording launch trace spans to '%s'", KFMON_TRACEFILE);
+	return EXIT_SUCCESS;
+}
+
+// Stop recording launch trace spans
+static void
+    trace_disable(void)
+{
+	pthread_mutex_lock(&tracelock);
+	if (!launchTrace.enabled) {
+		pthread_mutex_unlock(&tracelock);
+		return;
+	}
+
+	__atomic_store_n(&launchTrace.enabled, false, __ATOMIC_RELEASE);
+	close(launchTrace.fd);
+	launchTrace.fd   = -1;
+	launchTrace.size = 0U;
+	pthread_mutex_unlock(&tracelock);
+
+	LOG(LOG_NOTICE, "Stopped recording launch trace spans");
+}
+
+// Remember when a span started (if we're actually tracing, otherwise, the span will simply be discarded)
+static void
+    trace_mark(struct timespec* restrict ts)
+{
+	if (likely(!__atomic_load_n(&launchTrace.enabled, __ATOMIC_ACQUIRE))) {
+		*ts = (const struct timespec) { 0 };
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC_RAW, ts);
+}
+
+// Record a complete span, from start to now, tagged with the watch index it's relevant to (-1 if none).
+// By default, spans are recorded on the current thread's track, pass a pid as tid to use a different one.
+// NOTE: Thread-safe, as this is also used in reaper threads.
+static void
+    trace_span(const char* restrict name,
+	       const char* restrict cat,
+	       const struct timespec* restrict start,
+	       int8_t watch_idx,
+	       pid_t  tid)
+{
+	// Discard spans that started before we were tracing
+	if (likely(!__atomic_load_n(&launchTrace.enabled, __ATOMIC_ACQUIRE)) ||
+	    (start->tv_sec == 0 && start->tv_nsec == 0)) {
+		return;
+	}
+
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	// Timestamps are expected in µs
+	long long int ts  = (long long int) start->tv_sec * 1000000LL + start->tv_nsec / 1000L;
+	long long int dur = ((long long int) now.tv_sec * 1000000LL + now.tv_nsec / 1000L) - ts;
+	if (tid == 0) {
+		tid = (pid_t) syscall(SYS_gettid);
+	}
+
+	char buf[256];
+	int  len = snprintf(buf,
+			    sizeof(buf),
+			    "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":%ld,\"tid\":%ld,"
+			    "\"args\":{\"watch\":%hhd}},\n",
+			    name,
+			    cat,
+			    ts,
+			    dur,
+			    (long) getpid(),
+			    (long) tid,
+			    watch_idx);
+	if (len < 0 || (size_t) len >= sizeof(buf)) {
+		return;
+	}
+
+	pthread_mutex_lock(&tracelock);
+	// Check again now that we hold the lock, in case we were disabled in the meantime...
+	if (launchTrace.enabled) {
+		// Keep the file size in check by starting over once we've blown past our cap
+		if (launchTrace.size + (size_t) len > TRACE_SZ_MAX) {
+			if (ftruncate(launchTrace.fd, 0) == 0 && lseek(launchTrace.fd, 0, SEEK_SET) == 0) {
+				launchTrace.size = write_in_full(launchTrace.fd, "[\n", 2U) == 2 ? 2U : 0U;
+			}
+		}
+		if (write_in_full(launchTrace.fd, buf, (size_t) len) > 0) {
+			launchTrace.size += (size_t) len;
+		}
+	}
+	pthread_mutex_unlock(&tracelock);
+}
+
+// Parse a syslog-ish log level name (e.g., info or warning)
+static int
+    parse_log_level(const char* str, uint8_t* level)
+{
+	if (strcasecmp(str, "error") == 0) {
+		*level = LOG_ERR;
+		return EXIT_SUCCESS;
+	}
+	if (strcasecmp(str, "warn") == 0) {
+		*level = LOG_WARNING;
+		return EXIT_SUCCESS;
+	}
+	for (uint8_t i = LOG_EMERG; i <= LOG_DEBUG; i++) {
+		if (strcasecmp(str, log_level_to_str(i)) == 0) {
+			*level = i;
+			return EXIT_SUCCESS;
+		}
+	}
+	return -1;
+}
+
+static const char*
+    log_level_to_str(uint8_t level)
+{
+	switch (level) {
+		case LOG_EMERG:
+			return "emerg";
+		case LOG_ALERT:
+			return "alert";
+		case LOG_CRIT:
+			return "crit";
+		case LOG_ERR:
+			return "err";
+		case LOG_WARNING:
+			return "warning";
+		case LOG_NOTICE:
+			return "notice";
+		case LOG_INFO:
+			return "info";
+		case LOG_DEBUG:
+			return "debug";
+		default:
+			return "unknown";
+	}
+}
+
+// Returns the LogCategory matching name, or -1
+static int
+    parse_log_category(const char* name)
+{
+	static const char* const categories[] = LOG_CATEGORIES;
+
+	for (int cat = LOG_CAT_GENERAL; cat < LOG_CAT_MAX; cat++) {
+		if (strcasecmp(name, categories[cat]) == 0) {
+			return cat;
+		}
+	}
+	return -1;
+}
+
+// Apply the log levels from our config (categories w/o one of their own follow the general one)
+static void
+    apply_log_levels(void)
+{
+	uint8_t general = daemonConfig.log_levels[LOG_CAT_GENERAL] > 0U
+			      ? (uint8_t) (daemonConfig.log_levels[LOG_CAT_GENERAL] - 1U)
+			      : (uint8_t) LOG_LEVEL_DEFAULT;
+	for (uint8_t cat = LOG_CAT_GENERAL; cat < LOG_CAT_MAX; cat++) {
+		uint8_t level =
+		    daemonConfig.log_levels[cat] > 0U ? (uint8_t) (daemonConfig.log_levels[cat] - 1U) : general;
+		__atomic_store_n(&logLevels[cat], level, __ATOMIC_RELAXED);
+	}
+
+	char buf[256];
+	format_log_levels(buf, sizeof(buf), ", ");
+	CLOG(LOG_CAT_CONFIG, LOG_NOTICE, "Log levels: %s", buf);
+}
+
+// Format the current log level of each category as category:level pairs, separated by sep
+static int
+    format_log_levels(char* buf, size_t size, const char* sep)
+{
+	static const char* const categories[] = LOG_CATEGORIES;
+
+	int len = 0;
+	buf[0]  = '\0';
+	for (uint8_t cat = LOG_CAT_GENERAL; cat < LOG_CAT_MAX && (size_t) len < size; cat++) {
+		len += snprintf(buf + len,
+				size - (size_t) len,
+				"%s%s:%s",
+				cat > LOG_CAT_GENERAL ? sep : "",
+				categories[cat],
+				log_level_to_str(__atomic_load_n(&logLevels[cat], __ATOMIC_RELAXED)));
+	}
+	return MIN(len, (int) size - 1);
+}
+
+// (Re)open our journal file, and start a new session in it.
+// If there's an existing file that doesn't match our format, it's moved out of the way.
+// If a partial record had to be dropped from the end of the existing file, its size is stored in dropped (if not NULL).
+// NOTE: Expects journallock to be held, which means we can't log anything in here!
+//       Returns -1 w/ errno set on failure.
+static int
+    journal_start_file(off_t* dropped)
+{
+	if (dropped) {
+		*dropped = 0;
+	}
+
+	int fd =
+	    open(KFMON_JOURNAL, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd == -1) {
+		return -1;
+	}
+
+	JournalHeader header = { .version = KFMON_JOURNAL_VERSION, .record_size = sizeof(JournalRecord) };
+	memcpy(header.magic, KFMON_JOURNAL_MAGIC, sizeof(header.magic));
+
+	struct stat st;
+	if (fstat(fd, &st) == -1) {
+		int err = errno;
+		close(fd);
+		errno = err;
+		return -1;
+	}
+	if (st.st_size > 0) {
+		JournalHeader cur_header = { 0 };
+		if (pread(fd, &cur_header, sizeof(cur_header), 0) != (ssize_t) sizeof(cur_header) ||
+		    memcmp(&cur_header, &header, sizeof(header)) != 0) {
+			close(fd);
+			if (rename(KFMON_JOURNAL, KFMON_JOURNAL ".old") == -1) {
+				return -1;
+			}
+			return journal_start_file(dropped);
+		}
+		// A short write (e.g., ENOSPC, or a crash) may have left a partial record behind,
+		// drop it, otherwise every record we append after it would be misaligned.
+		off_t partial = (st.st_size - (off_t) sizeof(header)) % (off_t) sizeof(JournalRecord);
+		if (partial != 0) {
+			if (ftruncate(fd, st.st_size - partial) == -1) {
+				int err = errno;
+				close(fd);
+				errno = err;
+				return -1;
+			}
+			st.st_size -= partial;
+			if (dropped) {
+				*dropped = partial;
+			}
+		}
+	} else if (write_in_full(fd, &header, sizeof(header)) != (ssize_t) sizeof(header)) {
+		int err = errno;
+		close(fd);
+		errno = err;
+		return -1;
+	}
+
+	__atomic_store_n(&eventJournal.fd, fd, __ATOMIC_RELEASE);
+	eventJournal.size = MAX((size_t) st.st_size, sizeof(header));
+	memset(eventJournal.names, 0, sizeof(eventJournal.names));
+
+	// Let the decoder know how to map our timestamps to the wall clock
+	struct timespec boot_ts = { 0 };
+	struct timespec real_ts = { 0 };
+	clock_gettime(CLOCK_BOOTTIME, &boot_ts);
+	clock_gettime(CLOCK_REALTIME, &real_ts);
+	JournalRecord* restrict record = &eventJournal.records[eventJournal.count++];
+	*record                        = (const JournalRecord) { 0 };
+	record->ts_ms                  = (uint64_t) boot_ts.tv_sec * 1000U + (uint64_t) boot_ts.tv_nsec / 1000000U;
+	record->type                   = JOURNAL_EV_SESSION;
+	record->watch_idx              = -1;
+	record->source                 = JOURNAL_SRC_NONE;
+	record->session.realtime_ms    = (int64_t) real_ts.tv_sec * 1000 + real_ts.tv_nsec / 1000000L;
+	record->session.pid            = (uint32_t) getpid();
+	return EXIT_SUCCESS;
+}
+
+// Start recording launch events to our journal
+static void
+    journal_open(void)
+{
+	static bool was_opened = false;
+
+	pthread_mutex_lock(&journallock);
+	if (eventJournal.fd != -1) {
+		pthread_mutex_unlock(&journallock);
+		return;
+	}
+	off_t dropped = 0;
+	int   ret     = journal_start_file(&dropped);
+	int   err     = errno;
+	pthread_mutex_unlock(&journallock);
+
+	if (ret == -1) {
+		errno = err;
+		LOG(LOG_WARNING, "Failed to open our event journal '%s': %m", KFMON_JOURNAL);
+		return;
+	}
+	if (dropped > 0) {
+		LOG(LOG_WARNING, "Dropped a truncated record (%lld bytes) from our event journal", (long long) dropped);
+	}
+	// Make sure we don't lose the last batch
+	if (!was_opened) {
+		atexit(journal_flush);
+		was_opened = true;
+	}
+	LOG(LOG_NOTICE, "Recording launch events to '%s'", KFMON_JOURNAL);
+}
+
+// Stop recording launch events
+static void
+    journal_close(void)
+{
+	pthread_mutex_lock(&journallock);
+	if (eventJournal.fd == -1) {
+		pthread_mutex_unlock(&journallock);
+		return;
+	}
+	journal_flush_locked();
+	close(eventJournal.fd);
+	__atomic_store_n(&eventJournal.fd, -1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&journallock);
+
+	LOG(LOG_NOTICE, "Stopped recording launch events");
+}
+
+// Write the current batch to the journal (or drop it, if that fails, as there isn't much else we can do about it).
+// NOTE: Expects journallock to be held.
+static void
+    journal_flush_locked(void)
+{
+	if (eventJournal.fd == -1 || eventJournal.count == 0U) {
+		eventJournal.count = 0U;
+		return;
+	}
+
+	size_t len = eventJournal.count * sizeof(*eventJournal.records);
+	if (write_in_full(eventJournal.fd, eventJournal.records, len) == (ssize_t) len) {
+		eventJournal.size += len;
+	}
+	eventJournal.count = 0U;
+
+	// Start a new file once we've blown past our cap
+	// (if that fails, the journal is simply disabled until the next restart or config reload).
+	if (eventJournal.size >= JOURNAL_SZ_MAX) {
+		close(eventJournal.fd);
+		__atomic_store_n(&eventJournal.fd, -1, __ATOMIC_RELEASE);
+		// NOTE: We've just moved it out of the way, so there's nothing to drop from the new one
+		if (rename(KFMON_JOURNAL, KFMON_JOURNAL ".old") == 0) {
+			journal_start_file(NULL);
+		}
+	}
+}
+
+static void
+    journal_flush(void)
+{
+	pthread_mutex_lock(&journallock);
+	journal_flush_locked();
+	pthread_mutex_unlock(&journallock);
+}
+
+// Append a record (timestamped here) to the journal, name being the basename of the watch's target file, if any.
+// NOTE: Thread-safe, as exits are recorded from the reaper threads.
+static void
+    journal_append(JournalRecord* record, const char* name)
+{
+	// Don't even bother w/ the lock if we're not recording
+	if (likely(__atomic_load_n(&eventJournal.fd, __ATOMIC_ACQUIRE) == -1)) {
+		return;
+	}
+
+	struct timespec boot_ts = { 0 };
+	clock_gettime(CLOCK_BOOTTIME, &boot_ts);
+	record->ts_ms = (uint64_t) boot_ts.tv_sec * 1000U + (uint64_t) boot_ts.tv_nsec / 1000000U;
+
+	pthread_mutex_lock(&journallock);
+	// Make room for a watch record, too (and take care of a possible rotation *before* we check the names)
+	if (eventJournal.count + 2U > JOURNAL_BATCH) {
+		journal_flush_locked();
+	}
+	if (eventJournal.fd == -1) {
+		pthread_mutex_unlock(&journallock);
+		return;
+	}
+
+	// Let the decoder know what that watch idx means, if we haven't yet (or if the slot was reused since)
+	if (name && record->watch_idx >= 0 && record->watch_idx < WATCH_MAX) {
+		char* restrict known = eventJournal.names[record->watch_idx];
+		if (strncmp(known, name, JOURNAL_NAME_SZ) != 0) {
+			memset(known, 0, JOURNAL_NAME_SZ);
+			memcpy(known, name, strnlen(name, JOURNAL_NAME_SZ));
+
+			JournalRecord* restrict watch_record = &eventJournal.records[eventJournal.count++];
+			*watch_record                        = (const JournalRecord) { 0 };
+			watch_record->ts_ms                  = record->ts_ms;
+			watch_record->type                   = JOURNAL_EV_WATCH;
+			watch_record->watch_idx              = record->watch_idx;
+			watch_record->source                 = JOURNAL_SRC_NONE;
+			memcpy(watch_record->name, known, JOURNAL_NAME_SZ);
+		}
+	}
+	eventJournal.records[eventJournal.count++] = *record;
+
+	// If there's no logger thread to take care of it, don't wait
+	if (eventJournal.count == JOURNAL_BATCH || !__atomic_load_n(&logRing.is_running, __ATOMIC_ACQUIRE)) {
+		journal_flush_locked();
+	}
+	pthread_mutex_unlock(&journallock);
+}
+
+// Record a refused launch request, reason being one of the reasons we pass to blocked IPC events.
+static void
+    journal_blocked(uint8_t watch_idx, const char* reason)
+{
+	static const char* const reasons[] = JOURNAL_BLOCK_REASONS;
+
+	uint8_t code = JOURNAL_BLOCK_PROCESSING;
+	while (code < JOURNAL_BLOCK_UNKNOWN && strcmp(reasons[code], reason) != 0) {
+		code++;
+	}
+
+	JournalRecord record = { 0 };
+	record.type          = JOURNAL_EV_BLOCKED;
+	record.watch_idx     = (int8_t) watch_idx;
+	record.source        = JOURNAL_SRC_NONE;
+	record.spawn.code    = code;
+	journal_append(&record, basename(watchConfig[watch_idx].filename));
+}
+
+// Weed out repeats of the last notification we've shown (c.f., FB_PRINT)
+// NOTE: Expects fblock to be held.
+static bool
+    fb_should_print(const char* msg)
+{
+	unsigned int    hash = qhash((const unsigned char*) msg, strlen(msg));
+	struct timespec now  = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	bool should_print = hash != fbRepeat.hash || now.tv_sec - fbRepeat.ts.tv_sec >= FB_REPEAT_WINDOW;
+	if (should_print) {
+		fbRepeat.hash = hash;
+		fbRepeat.ts   = now;
 	}
-	if ((fd = open(KFMON_LOGFILE, flags, S_IRUSR | S_IWUSR)) != -1) {
-		dup2(fd, fileno(stderr));
-		if (fd > 2 + 3) {
-			close(fd);
+
+	return should_print;
+}
+
+// Leave pen mode, if we were in it
+// NOTE: Expects fblock to be held.
+static void
+    fb_leave_pen_mode(void)
+{
+	if (fbHandle.is_pen_mode) {
+		fbink_sunxi_toggle_ntx_pen_mode(fbHandle.fd, false);
+		fbHandle.is_pen_mode = false;
+	}
+}
+
+// Show a notification on screen (c.f., FB_PRINT)
+// NOTE: Thread-safe, as the reapers can print stuff, too.
+static void
+    fb_print(const char* msg)
+{
+	pthread_mutex_lock(&fblock);
+	if (fb_should_print(msg)) {
+		struct timespec ts;
+		trace_mark(&ts);
+		// Only enter pen mode once per batch (c.f., fb_begin_batch)
+		if (need_pen_mode && !fbHandle.is_pen_mode) {
+			fbink_sunxi_toggle_ntx_pen_mode(fbHandle.fd, true);
+			fbHandle.is_pen_mode = true;
 		}
-	} else {
-		PFLOG(LOG_CRIT, "Failed to redirect stderr to logfile '%s' (open: %m)", KFMON_LOGFILE);
-		return -1;
+
+		fbink_print(fbHandle.fd, msg, &fbinkConfig);
+
+		// Outside of a batch, we're on our own
+		if (fbHandle.batch_depth == 0U) {
+			fb_leave_pen_mode();
+		}
+		trace_span("fbink_print", "fbink", &ts, -1, 0);
 	}
+	pthread_mutex_unlock(&fblock);
+}
 
-	return 0;
+// Bracket a burst of notifications, so that we only toggle pen mode once for the lot of them.
+// NOTE: Pen mode is only entered on the first actual print, so an empty batch costs nothing.
+//       Keep these tight, though: don't let a batch span anything that may block (SQLite, fork & exec).
+static void
+    fb_begin_batch(void)
+{
+	pthread_mutex_lock(&fblock);
+	fbHandle.batch_depth++;
+	pthread_mutex_unlock(&fblock);
 }
 
-// Wrapper around localtime_r, making sure this part is thread-safe (used for logging)
-static struct tm*
-    get_localtime(struct tm* restrict lt)
+static void
+    fb_end_batch(void)
 {
-	time_t t = time(NULL);
-	tzset();
+	pthread_mutex_lock(&fblock);
+	if (fbHandle.batch_depth > 0U) {
+		fbHandle.batch_depth--;
+	}
+	if (fbHandle.batch_depth == 0U) {
+		fb_leave_pen_mode();
+	}
+	pthread_mutex_unlock(&fblock);
+}
 
-	return localtime_r(&t, lt);
+// Make sure FBInk's view of the fb is up to date
+// NOTE: With a persistent fd, this may remap the fb, so, don't let it happen in the middle of a print.
+static void
+    fb_reinit(void)
+{
+	pthread_mutex_lock(&fblock);
+	if (unlikely(fbink_reinit(fbHandle.fd, &fbinkConfig) < 0)) {
+		PFLOG(LOG_WARNING, "fbink_reinit: failure");
+	}
+	pthread_mutex_unlock(&fblock);
 }
 
-// Wrapper around strftime, making sure this part is thread-safe (used for logging)
-static char*
-    format_localtime(struct tm* restrict lt, char* restrict sz_time, size_t len)
+// Don't leave the fb in pen mode behind us, should we die in the middle of a batch
+static void
+    fb_cleanup(void)
 {
-	// c.f., strftime(3) & https://stackoverflow.com/questions/7411301
-	strftime(sz_time, len, "%Y-%m-%d @ %H:%M:%S", lt);
+	pthread_mutex_lock(&fblock);
+	fb_leave_pen_mode();
+	pthread_mutex_unlock(&fblock);
+}
 
-	return sz_time;
+// Remember when a latency sample started
+static void
+    stats_mark(struct timespec* restrict ts)
+{
+	clock_gettime(CLOCK_MONOTONIC_RAW, ts);
 }
 
-// Return the current time formatted as 2016-04-29 @ 20:44:13 (used for logging)
-// NOTE: The use of static variables prevents this from being thread-safe,
-//       but in the main thread, we use static storage for simplicity's sake.
-static char*
-    get_current_time(void)
+// Account for a latency sample, from start to now
+static void
+    stats_observe(LatencyKind kind, const struct timespec* restrict start)
 {
-	static struct tm local_tm = { 0 };
-	struct tm* restrict lt    = get_localtime(&local_tm);
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	long long int us =
+	    ((long long int) (now.tv_sec - start->tv_sec) * 1000000LL) + (now.tv_nsec - start->tv_nsec) / 1000L;
+	if (us < 0) {
+		us = 0;
+	}
 
-	static char sz_time[22];
+	// Bucket n is for (2^(n-1), 2^n] µs
+	uint8_t bucket = 0U;
+	if (us > 1) {
+		bucket = (uint8_t) MIN(64 - __builtin_clzll((unsigned long long int) (us - 1)), (int) STATS_BUCKETS - 1);
+	}
 
-	return format_localtime(lt, sz_time, sizeof(sz_time));
+	LatencyHistogram* restrict hist = &kfStats.latency[kind];
+	hist->buckets[bucket]++;
+	hist->count++;
+	hist->sum_us += (uint64_t) us;
 }
 
-// And now the same, but with user supplied storage, thus potentially thread-safe:
-// e.g., we use the stack in reaper_thread().
-static char*
-    get_current_time_r(struct tm* restrict local_tm, char* restrict sz_time, size_t len)
+// CPU time used by a specific thread (or by the whole process, with CLOCK_PROCESS_CPUTIME_ID), in µs
+static uint64_t
+    get_thread_cpu_us(clockid_t clock_id)
 {
-	struct tm* restrict lt = get_localtime(local_tm);
-	return format_localtime(lt, sz_time, len);
+	struct timespec ts = { 0 };
+	if (clock_gettime(clock_id, &ts) == -1) {
+		return 0U;
+	}
+
+	return (uint64_t) ts.tv_sec * 1000000U + (uint64_t) ts.tv_nsec / 1000U;
 }
 
 static const char*
-    get_log_prefix(int prio)
+    latency_kind_to_str(LatencyKind kind)
 {
-	// Reuse (part of) the syslog() priority constants
-	switch (prio) {
-		case LOG_CRIT:
-			return "CRIT";
-		case LOG_ERR:
-			return "ERR!";
-		case LOG_WARNING:
-			return "WARN";
-		case LOG_NOTICE:
-			return "NOTE";
-		case LOG_INFO:
-			return "INFO";
-		case LOG_DEBUG:
-			return "DBG!";
+	switch (kind) {
+		case LATENCY_DECISION:
+			return "decision";
+		case LATENCY_SQL:
+			return "sql";
+		case LATENCY_THUMBNAILS:
+			return "thumbnails";
+		case LATENCY_EXEC:
+			return "exec";
 		default:
-			return "OOPS";
+			return "unknown";
+	}
+}
+
+// Dump our metrics to KFMON_STATSFILE, in the Prometheus text format
+// c.f., https://prometheus.io/docs/instrumenting/exposition_formats/
+static int
+    stats_dump(void)
+{
+	// Write to a temporary file first, and swap it in, so that scrapers never see a partial dump
+	FILE* f = fopen(KFMON_STATSFILE ".tmp", "we");
+	if (!f) {
+		PFLOG(LOG_WARNING, "fopen: %m");
+		return -1;
+	}
+
+	uint64_t reapers_cpu_us;
+	pthread_mutex_lock(&ptlock);
+	reapers_cpu_us = kfStats.reapers_cpu_us;
+	pthread_mutex_unlock(&ptlock);
+
+	typedef struct
+	{
+		const char* name;
+		uint64_t    value;
+	} StatsCounter;
+
+	const StatsCounter events[] = {
+		{     "open",     kfStats.inotify_open },
+		{    "close",    kfStats.inotify_close },
+		{  "unmount",  kfStats.inotify_unmount },
+		{  "ignored",  kfStats.inotify_ignored },
+		{ "overflow", kfStats.inotify_overflow },
+	};
+	fprintf(f, "# TYPE kfmon_inotify_events_total counter\n");
+	for (size_t i = 0U; i < ARRAY_SIZE(events); i++) {
+		fprintf(f,
+			"kfmon_inotify_events_total{mask=\"%s\"} %llu\n",
+			events[i].name,
+			(unsigned long long int) events[i].value);
+	}
+
+	const StatsCounter counters[] = {
+		{         "db_checks",         kfStats.db_checks },
+		{ "db_checks_skipped", kfStats.db_checks_skipped },
+		{         "db_errors",         kfStats.db_errors },
+		{            "spawns",            kfStats.spawns },
+		{     "exec_failures",     kfStats.exec_failures },
+		{  "blocked_triggers",  kfStats.blocked_triggers },
+		{   "queued_triggers",   kfStats.queued_triggers },
+		{  "dropped_triggers",  kfStats.dropped_triggers },
+		{    "watchdog_kills",    kfStats.watchdog_kills },
+		{   "ipc_connections",   kfStats.ipc_connections },
+		{      "ipc_commands",      kfStats.ipc_commands },
+		{        "ipc_errors",        kfStats.ipc_errors },
+		{       "ipc_dropped",       kfStats.ipc_dropped },
+	};
+	for (size_t i = 0U; i < ARRAY_SIZE(counters); i++) {
+		fprintf(f, "# TYPE kfmon_%s_total counter\n", counters[i].name);
+		fprintf(f, "kfmon_%s_total %llu\n", counters[i].name, (unsigned long long int) counters[i].value);
+	}
+
+	fprintf(f, "# TYPE kfmon_latency_seconds histogram\n");
+	for (LatencyKind kind = LATENCY_DECISION; kind < LATENCY_MAX; kind++) {
+		const LatencyHistogram* restrict hist = &kfStats.latency[kind];
+		const char*                      name = latency_kind_to_str(kind);
+
+		// Prometheus buckets are cumulative
+		uint64_t total = 0U;
+		for (uint8_t n = 0U; n < STATS_BUCKETS - 1U; n++) {
+			total += hist->buckets[n];
+			fprintf(f,
+				"kfmon_latency_seconds_bucket{op=\"%s\",le=\"%g\"} %llu\n",
+				name,
+				(double) (1ULL << n) / 1e6,
+				(unsigned long long int) total);
+		}
+		fprintf(f,
+			"kfmon_latency_seconds_bucket{op=\"%s\",le=\"+Inf\"} %llu\n",
+			name,
+			(unsigned long long int) hist->count);
+		fprintf(f, "kfmon_latency_seconds_sum{op=\"%s\"} %g\n", name, (double) hist->sum_us / 1e6);
+		fprintf(f, "kfmon_latency_seconds_count{op=\"%s\"} %llu\n", name, (unsigned long long int) hist->count);
+	}
+
+	uint64_t main_cpu_us = get_thread_cpu_us(CLOCK_THREAD_CPUTIME_ID);
+	uint64_t all_cpu_us  = get_thread_cpu_us(CLOCK_PROCESS_CPUTIME_ID);
+	fprintf(f, "# TYPE kfmon_cpu_seconds_total counter\n");
+	fprintf(f, "kfmon_cpu_seconds_total{thread=\"main\"} %g\n", (double) main_cpu_us / 1e6);
+	fprintf(f, "kfmon_cpu_seconds_total{thread=\"reapers\"} %g\n", (double) reapers_cpu_us / 1e6);
+	fprintf(f, "kfmon_cpu_seconds_total{thread=\"all\"} %g\n", (double) all_cpu_us / 1e6);
+
+	sqlite3_int64 cur = 0;
+	sqlite3_int64 hi  = 0;
+	sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &cur, &hi, 0);
+	fprintf(f, "# TYPE kfmon_sqlite_memory_bytes gauge\n");
+	fprintf(f, "kfmon_sqlite_memory_bytes %lld\n", (long long int) cur);
+	fprintf(f, "# TYPE kfmon_sqlite_memory_highwater_bytes gauge\n");
+	fprintf(f, "kfmon_sqlite_memory_highwater_bytes %lld\n", (long long int) hi);
+
+	if (fclose(f) != 0) {
+		PFLOG(LOG_WARNING, "fclose: %m");
+		unlink(KFMON_STATSFILE ".tmp");
+		return -1;
 	}
+	if (rename(KFMON_STATSFILE ".tmp", KFMON_STATSFILE) == -1) {
+		PFLOG(LOG_WARNING, "rename: %m");
+		unlink(KFMON_STATSFILE ".tmp");
+		return -1;
+	}
+
+	return EXIT_SUCCESS;
 }
 
 // Check that our target mountpoint is indeed mounted...
@@ -397,24 +1709,77 @@ static int
 #define MATCH(s, n) strcmp(section, s) == 0 && strcmp(key, n) == 0
 	if (MATCH("daemon", "db_timeout")) {
 		if (strtoul_hu(value, &pconfig->db_timeout) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for db_timeout!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for db_timeout!");
+			return 0;
+		}
+	} else if (MATCH("daemon", "queue_ttl")) {
+		if (strtoul_hu(value, &pconfig->queue_ttl) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for queue_ttl!");
+			return 0;
+		}
+	} else if (MATCH("daemon", "log_flush")) {
+		if (strtoul_hu(value, &pconfig->log_flush) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for log_flush!");
+			return 0;
+		}
+	} else if (MATCH("daemon", "log_segment_size")) {
+		if (strtoul_hu(value, &pconfig->log_segment_size) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for log_segment_size!");
+			return 0;
+		}
+	} else if (MATCH("daemon", "log_segments")) {
+		if (strtoul_hu(value, &pconfig->log_segments) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for log_segments!");
+			return 0;
+		}
+	} else if (MATCH("daemon", "log_compress")) {
+		if (strtobool(value, &pconfig->log_compress) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for log_compress!");
+			return 0;
+		}
+	} else if (MATCH("daemon", "log_to_ram")) {
+		if (strtobool(value, &pconfig->log_to_ram) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for log_to_ram!");
+			return 0;
+		}
+	} else if (MATCH("daemon", "journal")) {
+		if (strtobool(value, &pconfig->journal) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for journal!");
 			return 0;
 		}
 	} else if (MATCH("daemon", "use_syslog")) {
 		if (strtobool(value, &pconfig->use_syslog) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for use_syslog!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for use_syslog!");
 			return 0;
 		}
 	} else if (MATCH("daemon", "with_notifications")) {
 		if (strtobool(value, &pconfig->with_notifications) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for with_notifications!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for with_notifications!");
 			return 0;
 		}
 	} else if (MATCH("daemon", "with_storage_notifications")) {
 		if (strtobool(value, &pconfig->with_storage_notifications) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for with_storage_notifications!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for with_storage_notifications!");
+			return 0;
+		}
+	} else if (strcmp(section, "daemon") == 0 && strncmp(key, "log_level", 9U) == 0) {
+		// Either log_level, or log_level_category
+		int cat = LOG_CAT_GENERAL;
+		if (key[9] == '_') {
+			cat = parse_log_category(key + 10);
+		} else if (key[9] != '\0') {
+			cat = -1;
+		}
+		uint8_t level;
+		if (cat < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Unknown log category in %s!", key);
+			return 0;
+		}
+		if (parse_log_level(value, &level) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for %s!", key);
 			return 0;
 		}
+		pconfig->log_levels[cat] = (uint8_t) (level + 1U);
 	} else {
 		return 0;    // unknown section/name, error
 	}
@@ -430,50 +1795,60 @@ static int
 #define MATCH(s, n) strcmp(section, s) == 0 && strcmp(key, n) == 0
 	if (MATCH("watch", "filename")) {
 		if (str5cpy(pconfig->filename, CFG_SZ_MAX, value, CFG_SZ_MAX, NOTRUNC) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for filename (too long?)!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for filename (too long?)!");
 			return 0;
 		}
 	} else if (MATCH("watch", "action")) {
 		if (str5cpy(pconfig->action, CFG_SZ_MAX, value, CFG_SZ_MAX, NOTRUNC) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for action (too long?)!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for action (too long?)!");
 			return 0;
 		}
 	} else if (MATCH("watch", "label")) {
 		if (str5cpy(pconfig->label, CFG_SZ_MAX, value, CFG_SZ_MAX, TRUNC) < 0) {
-			LOG(LOG_WARNING, "The value passed for label may have been truncated!");
+			CLOG(LOG_CAT_CONFIG, LOG_WARNING, "The value passed for label may have been truncated!");
 		}
 	} else if (MATCH("watch", "hidden")) {
 		if (strtobool(value, &pconfig->hidden) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for hidden!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for hidden!");
 			return 0;
 		}
 	} else if (MATCH("watch", "block_spawns")) {
 		if (strtobool(value, &pconfig->block_spawns) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for block_spawns!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for block_spawns!");
 			return 0;
 		}
 	} else if (MATCH("watch", "skip_db_checks")) {
 		if (strtobool(value, &pconfig->skip_db_checks) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for skip_db_checks!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for skip_db_checks!");
 			return 0;
 		}
 	} else if (MATCH("watch", "do_db_update")) {
 		if (strtobool(value, &pconfig->do_db_update) < 0) {
-			LOG(LOG_CRIT, "Passed an invalid value for do_db_update!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for do_db_update!");
+			return 0;
+		}
+	} else if (MATCH("watch", "max_runtime")) {
+		if (strtoul_hu(value, &pconfig->max_runtime) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for max_runtime!");
+			return 0;
+		}
+	} else if (MATCH("watch", "max_idle")) {
+		if (strtoul_hu(value, &pconfig->max_idle) < 0) {
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Passed an invalid value for max_idle!");
 			return 0;
 		}
 	} else if (MATCH("watch", "db_title")) {
 		// NOTE: str5cpy returns OKTRUNC (1) if we allow truncation, which we do here
 		if (str5cpy(pconfig->db_title, DB_SZ_MAX, value, DB_SZ_MAX, TRUNC) != 0) {
-			LOG(LOG_WARNING, "The value passed for db_title may have been truncated!");
+			CLOG(LOG_CAT_CONFIG, LOG_WARNING, "The value passed for db_title may have been truncated!");
 		}
 	} else if (MATCH("watch", "db_author")) {
 		if (str5cpy(pconfig->db_author, DB_SZ_MAX, value, DB_SZ_MAX, TRUNC) != 0) {
-			LOG(LOG_WARNING, "The value passed for db_author may have been truncated!");
+			CLOG(LOG_CAT_CONFIG, LOG_WARNING, "The value passed for db_author may have been truncated!");
 		}
 	} else if (MATCH("watch", "db_comment")) {
 		if (str5cpy(pconfig->db_comment, DB_SZ_MAX, value, DB_SZ_MAX, TRUNC) != 0) {
-			LOG(LOG_WARNING, "The value passed for db_comment may have been truncated!");
+			CLOG(LOG_CAT_CONFIG, LOG_WARNING, "The value passed for db_comment may have been truncated!");
 		}
 	} else if (MATCH("watch", "reboot_on_exit")) {
 		;
@@ -492,7 +1867,7 @@ static bool
 	bool sane = true;
 
 	if (pconfig->filename[0] == '\0') {
-		LOG(LOG_CRIT, "Mandatory key 'filename' is missing or blank!");
+		CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'filename' is missing or blank!");
 		sane = false;
 	} else {
 		// Make sure we're not trying to set multiple watches on the same file...
@@ -516,18 +1891,22 @@ static bool
 		}
 		// As we're not yet flagged active, we won't loop over ourselves ;).
 		if (matches >= 1U) {
-			LOG(LOG_WARNING, "Tried to setup multiple watches on file '%s'!", pconfig->filename);
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_WARNING,
+			     "Tried to setup multiple watches on file '%s'!",
+			     pconfig->filename);
 			sane = false;
 		}
 		if (bmatches >= 1U) {
-			LOG(LOG_WARNING,
-			    "Tried to setup multiple watches on files with an identical basename: '%s'!",
-			    basename(pconfig->filename));
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_WARNING,
+			     "Tried to setup multiple watches on files with an identical basename: '%s'!",
+			     basename(pconfig->filename));
 			sane = false;
 		}
 	}
 	if (pconfig->action[0] == '\0') {
-		LOG(LOG_CRIT, "Mandatory key 'action' is missing or blank!");
+		CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'action' is missing or blank!");
 		sane = false;
 	}
 
@@ -536,15 +1915,15 @@ static bool
 	// If we asked for a database update, the next three keys become mandatory
 	if (pconfig->do_db_update) {
 		if (pconfig->db_title[0] == '\0') {
-			LOG(LOG_CRIT, "Mandatory key 'db_title' is missing or blank!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'db_title' is missing or blank!");
 			sane = false;
 		}
 		if (pconfig->db_author[0] == '\0') {
-			LOG(LOG_CRIT, "Mandatory key 'db_author' is missing or blank!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'db_author' is missing or blank!");
 			sane = false;
 		}
 		if (pconfig->db_comment[0] == '\0') {
-			LOG(LOG_CRIT, "Mandatory key 'db_comment' is missing or blank!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'db_comment' is missing or blank!");
 			sane = false;
 		}
 	}
@@ -562,7 +1941,7 @@ static bool
 	bool updated = false;
 
 	if (pconfig->filename[0] == '\0') {
-		LOG(LOG_CRIT, "Mandatory key 'filename' is missing or blank!");
+		CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'filename' is missing or blank!");
 		sane = false;
 	} else {
 		// Did it change?
@@ -593,13 +1972,17 @@ static bool
 			}
 			// We explicitly make sure not to loop over ourselves ;).
 			if (matches >= 1U) {
-				LOG(LOG_WARNING, "Tried to setup multiple watches on file '%s'!", pconfig->filename);
+				CLOG(LOG_CAT_CONFIG,
+				     LOG_WARNING,
+				     "Tried to setup multiple watches on file '%s'!",
+				     pconfig->filename);
 				sane = false;
 			}
 			if (bmatches >= 1U) {
-				LOG(LOG_WARNING,
-				    "Tried to setup multiple watches on files with an identical basename: '%s'!",
-				    basename(pconfig->filename));
+				CLOG(LOG_CAT_CONFIG,
+				     LOG_WARNING,
+				     "Tried to setup multiple watches on files with an identical basename: '%s'!",
+				     basename(pconfig->filename));
 				sane = false;
 			}
 			if (sane) {
@@ -608,24 +1991,26 @@ static bool
 				str5cpy(
 				    watchConfig[target_idx].filename, CFG_SZ_MAX, pconfig->filename, CFG_SZ_MAX, NOTRUNC);
 				updated = true;
-				LOG(LOG_NOTICE,
-				    "Updated filename to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].filename,
-				    target_idx);
+				CLOG(LOG_CAT_CONFIG,
+				     LOG_NOTICE,
+				     "Updated filename to '%s' for watch config @ index %hhu",
+				     watchConfig[target_idx].filename,
+				     target_idx);
 			}
 		}
 	}
 	if (pconfig->action[0] == '\0') {
-		LOG(LOG_CRIT, "Mandatory key 'action' is missing or blank!");
+		CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'action' is missing or blank!");
 		sane = false;
 	} else {
 		if (strcmp(pconfig->action, watchConfig[target_idx].action) != 0) {
 			str5cpy(watchConfig[target_idx].action, CFG_SZ_MAX, pconfig->action, CFG_SZ_MAX, NOTRUNC);
 			updated = true;
-			LOG(LOG_NOTICE,
-			    "Updated action to '%s' for watch config @ index %hhu",
-			    watchConfig[target_idx].action,
-			    target_idx);
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_NOTICE,
+			     "Updated action to '%s' for watch config @ index %hhu",
+			     watchConfig[target_idx].action,
+			     target_idx);
 		}
 	}
 
@@ -633,125 +2018,613 @@ static bool
 	if (strcmp(pconfig->label, watchConfig[target_idx].label) != 0) {
 		str5cpy(watchConfig[target_idx].label, CFG_SZ_MAX, pconfig->label, CFG_SZ_MAX, TRUNC);
 		updated = true;
-		LOG(LOG_NOTICE,
-		    "Updated label to '%s' for watch config @ index %hhu",
-		    watchConfig[target_idx].label,
-		    target_idx);
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Updated label to '%s' for watch config @ index %hhu",
+		     watchConfig[target_idx].label,
+		     target_idx);
 	}
 
 	// Check if hidden was updated...
 	if (pconfig->hidden != watchConfig[target_idx].hidden) {
 		watchConfig[target_idx].hidden = pconfig->hidden;
 		updated                        = true;
-		LOG(LOG_NOTICE,
-		    "Updated hidden to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].hidden),
-		    target_idx);
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Updated hidden to %s for watch config @ index %hhu",
+		     BOOL2STR(watchConfig[target_idx].hidden),
+		     target_idx);
 	}
 
 	// Check if block_spawns was updated...
 	if (pconfig->block_spawns != watchConfig[target_idx].block_spawns) {
 		watchConfig[target_idx].block_spawns = pconfig->block_spawns;
 		updated                              = true;
-		LOG(LOG_NOTICE,
-		    "Updated block_spawns to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].block_spawns),
-		    target_idx);
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Updated block_spawns to %s for watch config @ index %hhu",
+		     BOOL2STR(watchConfig[target_idx].block_spawns),
+		     target_idx);
 	}
 
 	// Check if skip_db_checks was updated...
 	if (pconfig->skip_db_checks != watchConfig[target_idx].skip_db_checks) {
 		watchConfig[target_idx].skip_db_checks = pconfig->skip_db_checks;
 		updated                                = true;
-		LOG(LOG_NOTICE,
-		    "Updated skip_db_checks to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].skip_db_checks),
-		    target_idx);
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Updated skip_db_checks to %s for watch config @ index %hhu",
+		     BOOL2STR(watchConfig[target_idx].skip_db_checks),
+		     target_idx);
 	}
 
 	// Check if do_db_update was updated...
 	if (pconfig->do_db_update != watchConfig[target_idx].do_db_update) {
 		watchConfig[target_idx].do_db_update = pconfig->do_db_update;
 		updated                              = true;
-		LOG(LOG_NOTICE,
-		    "Updated do_db_update to %s for watch config @ index %hhu",
-		    BOOL2STR(watchConfig[target_idx].do_db_update),
-		    target_idx);
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Updated do_db_update to %s for watch config @ index %hhu",
+		     BOOL2STR(watchConfig[target_idx].do_db_update),
+		     target_idx);
+	}
+
+	// Check if max_runtime was updated...
+	if (pconfig->max_runtime != watchConfig[target_idx].max_runtime) {
+		watchConfig[target_idx].max_runtime = pconfig->max_runtime;
+		updated                             = true;
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Updated max_runtime to %hu for watch config @ index %hhu",
+		     watchConfig[target_idx].max_runtime,
+		     target_idx);
+	}
+
+	// Check if max_idle was updated...
+	if (pconfig->max_idle != watchConfig[target_idx].max_idle) {
+		watchConfig[target_idx].max_idle = pconfig->max_idle;
+		updated                          = true;
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Updated max_idle to %hu for watch config @ index %hhu",
+		     watchConfig[target_idx].max_idle,
+		     target_idx);
 	}
 
 	// If we asked for a database update, the next three keys become mandatory
 	if (pconfig->do_db_update) {
 		if (pconfig->db_title[0] == '\0') {
-			LOG(LOG_CRIT, "Mandatory key 'db_title' is missing or blank!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'db_title' is missing or blank!");
 			sane = false;
 		} else {
 			if (strcmp(pconfig->db_title, watchConfig[target_idx].db_title) != 0) {
 				str5cpy(watchConfig[target_idx].db_title, DB_SZ_MAX, pconfig->db_title, DB_SZ_MAX, TRUNC);
 				updated = true;
-				LOG(LOG_NOTICE,
-				    "Updated db_title to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].db_title,
-				    target_idx);
+				CLOG(LOG_CAT_CONFIG,
+				     LOG_NOTICE,
+				     "Updated db_title to '%s' for watch config @ index %hhu",
+				     watchConfig[target_idx].db_title,
+				     target_idx);
 			}
 		}
 		if (pconfig->db_author[0] == '\0') {
-			LOG(LOG_CRIT, "Mandatory key 'db_author' is missing or blank!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'db_author' is missing or blank!");
 			sane = false;
 		} else {
 			if (strcmp(pconfig->db_author, watchConfig[target_idx].db_author) != 0) {
 				str5cpy(
 				    watchConfig[target_idx].db_author, DB_SZ_MAX, pconfig->db_author, DB_SZ_MAX, TRUNC);
 				updated = true;
-				LOG(LOG_NOTICE,
-				    "Updated db_author to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].db_author,
-				    target_idx);
+				CLOG(LOG_CAT_CONFIG,
+				     LOG_NOTICE,
+				     "Updated db_author to '%s' for watch config @ index %hhu",
+				     watchConfig[target_idx].db_author,
+				     target_idx);
 			}
 		}
 		if (pconfig->db_comment[0] == '\0') {
-			LOG(LOG_CRIT, "Mandatory key 'db_comment' is missing or blank!");
+			CLOG(LOG_CAT_CONFIG, LOG_CRIT, "Mandatory key 'db_comment' is missing or blank!");
 			sane = false;
 		} else {
 			if (strcmp(pconfig->db_comment, watchConfig[target_idx].db_comment) != 0) {
 				str5cpy(
 				    watchConfig[target_idx].db_comment, DB_SZ_MAX, pconfig->db_comment, DB_SZ_MAX, TRUNC);
 				updated = true;
-				LOG(LOG_NOTICE,
-				    "Updated db_comment to '%s' for watch config @ index %hhu",
-				    watchConfig[target_idx].db_comment,
-				    target_idx);
+				CLOG(LOG_CAT_CONFIG,
+				     LOG_NOTICE,
+				     "Updated db_comment to '%s' for watch config @ index %hhu",
+				     watchConfig[target_idx].db_comment,
+				     target_idx);
+			}
+		}
+	}
+
+	if (sane && updated) {
+		FB_PRINTF("[KFMon] Updated the watch on %s", basename(watchConfig[target_idx].filename));
+		// Notify the caller
+		*was_updated = true;
+	}
+
+	return sane;
+}
+
+// Returns the index of the first usable entry in the watch list
+static int8_t
+    get_next_available_watch_entry(void)
+{
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (!watchConfig[watch_idx].is_active) {
+			return (int8_t) watch_idx;
+		}
+	}
+	return -1;
+}
+
+// Mimic scandir's alphasort
+static int
+    fts_alphasort(const FTSENT** a, const FTSENT** b)
+{
+	// NOTE: alphasort actually uses strcoll now, but this is Kobo, locales are broken anyway, so, strcmp is The Way.
+	//	 Or strverscmp is we wanted natural sorting, which we don't really need here ;).
+	return strcmp((*a)->fts_name, (*b)->fts_name);
+}
+
+// 64-bit FNV-1a, plenty good enough to tell whether a config file actually changed
+static uint64_t
+    fnv1a_update(uint64_t hash, const void* data, size_t len)
+{
+	const uint8_t* bytes = (const uint8_t*) data;
+	for (size_t i = 0U; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+static uint64_t
+    fnv1a_hash(const char* data, size_t len)
+{
+	return fnv1a_update(0xCBF29CE484222325ULL, data, len);
+}
+
+// Returns the fingerprint of that config file, or a fresh one if we don't know about it yet (NULL if we're out of room)
+static ConfigFingerprint*
+    get_config_fingerprint(const char* name)
+{
+	ConfigFingerprint* free_fp = NULL;
+	for (uint8_t i = 0U; i < CONFIG_FILES_MAX; i++) {
+		ConfigFingerprint* fp = &configFingerprints[i];
+		if (fp->name[0] == '\0') {
+			if (!free_fp) {
+				free_fp = fp;
+			}
+			continue;
+		}
+
+		if (strcmp(fp->name, name) == 0) {
+			return fp;
+		}
+	}
+
+	if (free_fp) {
+		*free_fp = (const ConfigFingerprint) { .watch_idx = -1 };
+		if (str5cpy(free_fp->name, sizeof(free_fp->name), name, NAME_MAX, NOTRUNC) < 0) {
+			free_fp->name[0] = '\0';
+			return NULL;
+		}
+	}
+	return free_fp;
+}
+
+// That watch slot was released, make sure no fingerprint still claims it
+static void
+    forget_config_fingerprints(uint8_t watch_idx)
+{
+	for (uint8_t i = 0U; i < CONFIG_FILES_MAX; i++) {
+		if (configFingerprints[i].watch_idx == (int8_t) watch_idx) {
+			configFingerprints[i].watch_idx  = -1;
+			configFingerprints[i].checked_at = 0;
+		}
+	}
+}
+
+// Check if we can trust a config file's stat data to tell us it hasn't changed since we last read it
+static bool
+    is_config_unchanged(const ConfigFingerprint* fp, const struct stat* st)
+{
+	if (fp->checked_at == 0 || fp->ino != st->st_ino || fp->size != st->st_size ||
+	    fp->mtime.tv_sec != st->st_mtim.tv_sec || fp->mtime.tv_nsec != st->st_mtim.tv_nsec) {
+		return false;
+	}
+
+	// If it was modified too close to our last check, it may have changed again since without its mtime moving.
+	return st->st_mtim.tv_sec + CONFIG_MTIME_SLOP < fp->checked_at;
+}
+
+// Slurp a config file (NUL-terminated, caller frees), and fingerprint it. Returns NULL on failure.
+static char*
+    read_config_file(const char* path, struct stat* st, uint64_t* hash)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		PFLOG(LOG_WARNING, "open: %m");
+		return NULL;
+	}
+
+	char* data = NULL;
+	if (fstat(fd, st) == -1) {
+		PFLOG(LOG_WARNING, "fstat: %m");
+		goto cleanup;
+	}
+	if (st->st_size > CONFIG_FILE_SZ_MAX) {
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_WARNING,
+		     "Config file '%s' is too large (%lld bytes)!",
+		     path,
+		     (long long) st->st_size);
+		goto cleanup;
+	}
+
+	data = calloc((size_t) st->st_size + 1U, sizeof(*data));
+	if (!data) {
+		PFLOG(LOG_WARNING, "calloc: %m");
+		goto cleanup;
+	}
+	ssize_t len = read_in_full(fd, data, (size_t) st->st_size);
+	if (len < 0) {
+		PFLOG(LOG_WARNING, "read: %m");
+		free(data);
+		data = NULL;
+		goto cleanup;
+	}
+	// Go with what we actually got, in case it shrank under our feet
+	st->st_size = (off_t) len;
+	*hash       = fnv1a_hash(data, (size_t) len);
+
+cleanup:
+	close(fd);
+	return data;
+}
+
+static void
+    update_config_fingerprint(ConfigFingerprint* fp,
+			      const struct stat* st,
+			      uint64_t           hash,
+			      int8_t             watch_idx,
+			      bool               is_broken)
+{
+	// We may have run out of room
+	if (!fp) {
+		return;
+	}
+
+	fp->ino        = st->st_ino;
+	fp->size       = st->st_size;
+	fp->mtime      = st->st_mtim;
+	fp->hash       = hash;
+	fp->checked_at = time(NULL);
+	fp->watch_idx  = watch_idx;
+	fp->is_broken  = is_broken;
+}
+
+// Cheap fingerprint of the config directory, without reading anything: the names, sizes & mtimes of its ini files.
+// NOTE: Inode numbers are left out on purpose, as they're not stable across mounts on vfat.
+static int
+    get_config_dir_hash(uint64_t* hash)
+{
+	DIR* dir = opendir(KFMON_CONFIGPATH);
+	if (!dir) {
+		PFLOG(LOG_WARNING, "opendir: %m");
+		return -1;
+	}
+
+	// Combine the entries in an order-independent way, as readdir doesn't sort anything
+	uint64_t       dir_hash = 0U;
+	struct dirent* de;
+	while ((de = readdir(dir)) != NULL) {
+		size_t len = strlen(de->d_name);
+		if (len <= 4U || strncasecmp(de->d_name + (len - 4U), ".ini", 4) != 0 || de->d_name[0] == '.') {
+			continue;
+		}
+
+		struct stat st;
+		if (fstatat(dirfd(dir), de->d_name, &st, 0) == -1 || !S_ISREG(st.st_mode)) {
+			continue;
+		}
+
+		int64_t  meta[3] = { (int64_t) st.st_size, (int64_t) st.st_mtim.tv_sec, (int64_t) st.st_mtim.tv_nsec };
+		uint64_t h       = fnv1a_hash(de->d_name, len);
+		dir_hash += fnv1a_update(h, meta, sizeof(meta));
+	}
+	closedir(dir);
+
+	*hash = dir_hash;
+	return EXIT_SUCCESS;
+}
+
+// Same idea, but only for the daemon configs (kfmon.ini & kfmon.user.ini),
+// so that we can tell whether daemonConfig is still accurate.
+static int
+    get_daemon_config_hash(uint64_t* hash)
+{
+	static const char* const names[] = { "kfmon.ini", "kfmon.user.ini" };
+
+	uint64_t cfg_hash = 0U;
+	for (size_t i = 0U; i < ARRAY_SIZE(names); i++) {
+		char path[PATH_MAX] = { 0 };
+		snprintf(path, sizeof(path), "%s/%s", KFMON_CONFIGPATH, names[i]);
+
+		struct stat st;
+		if (stat(path, &st) == -1) {
+			// The user config is optional, the main one isn't
+			if (errno == ENOENT && i > 0U) {
+				continue;
 			}
+			PFLOG(LOG_WARNING, "stat: %m");
+			return -1;
+		}
+
+		int64_t  meta[3] = { (int64_t) st.st_size, (int64_t) st.st_mtim.tv_sec, (int64_t) st.st_mtim.tv_nsec };
+		uint64_t h       = fnv1a_hash(names[i], strlen(names[i]));
+		cfg_hash += fnv1a_update(h, meta, sizeof(meta));
+	}
+
+	*hash = cfg_hash;
+	return EXIT_SUCCESS;
+}
+
+// Restore our config from its snapshot.
+// If is_validated, it's only used if the config directory hasn't changed since it was taken.
+static int
+    load_config_snapshot(bool is_validated)
+{
+	int fd = open(KFMON_CONFIG_SNAPSHOT, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		if (errno != ENOENT) {
+			PFLOG(LOG_WARNING, "open: %m");
+		}
+		return -1;
+	}
+
+	int             rval = -1;
+	ConfigSnapshot* snap = calloc(1U, sizeof(*snap));
+	if (!snap) {
+		PFLOG(LOG_WARNING, "calloc: %m");
+		goto cleanup;
+	}
+	if (read_in_full(fd, snap, sizeof(*snap)) != (ssize_t) sizeof(*snap)) {
+		CLOG(LOG_CAT_CONFIG, LOG_WARNING, "Config snapshot is truncated, ignoring it");
+		goto cleanup;
+	}
+
+	const size_t payload_offset = offsetof(ConfigSnapshot, daemon);
+	if (snap->magic != CONFIG_SNAPSHOT_MAGIC || snap->format != CONFIG_SNAPSHOT_VERSION ||
+	    snap->size != sizeof(*snap) || strcmp(snap->version, KFMON_VERSION) != 0 ||
+	    snap->checksum != fnv1a_update(0xCBF29CE484222325ULL,
+					   (const char*) snap + payload_offset,
+					   sizeof(*snap) - payload_offset)) {
+		CLOG(LOG_CAT_CONFIG, LOG_NOTICE, "Config snapshot is either stale or corrupted, ignoring it");
+		goto cleanup;
+	}
+
+	if (is_validated) {
+		uint64_t dir_hash = 0U;
+		if (get_config_dir_hash(&dir_hash) != EXIT_SUCCESS || dir_hash != snap->dir_hash) {
+			CLOG(LOG_CAT_CONFIG, LOG_INFO, "Config directory changed since our last snapshot");
+			goto cleanup;
+		}
+		// Paranoia: make sure the daemon config it holds was actually parsed from the current files
+		uint64_t daemon_hash = 0U;
+		if (get_daemon_config_hash(&daemon_hash) != EXIT_SUCCESS || daemon_hash != snap->daemon_hash) {
+			CLOG(LOG_CAT_CONFIG, LOG_INFO, "Daemon config changed since our last snapshot");
+			goto cleanup;
 		}
 	}
 
-	if (sane && updated) {
-		FB_PRINTF("[KFMon] Updated the watch on %s", basename(watchConfig[target_idx].filename));
-		// Notify the caller
-		*was_updated = true;
+	daemonConfig = snap->daemon;
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		watchConfig[watch_idx] = snap->watches[watch_idx];
+		// Reset the runtime state
+		watchConfig[watch_idx].processing_ts      = 0;
+		watchConfig[watch_idx].inotify_wd         = -1;
+		watchConfig[watch_idx].wd_was_destroyed   = false;
+		watchConfig[watch_idx].pending_processing = false;
 	}
+	for (uint8_t i = 0U; i < CONFIG_FILES_MAX; i++) {
+		configFingerprints[i]         = snap->files[i];
+		configFingerprints[i].is_seen = false;
+	}
+	configSnapshotHash = snap->dir_hash;
+	daemonConfigHash   = snap->daemon_hash;
+
+	CLOG(LOG_CAT_CONFIG,
+	     LOG_NOTICE,
+	     "Config loaded from our snapshot: db_timeout=%hu, queue_ttl=%hu, log_flush=%hu, log_segment_size=%hu, log_segments=%hu, log_compress=%s, log_to_ram=%s, use_syslog=%s, journal=%s, with_notifications=%s, with_storage_notifications=%s",
+	     daemonConfig.db_timeout,
+	     daemonConfig.queue_ttl,
+	     daemonConfig.log_flush,
+	     daemonConfig.log_segment_size,
+	     daemonConfig.log_segments,
+	     BOOL2STR(daemonConfig.log_compress),
+	     BOOL2STR(daemonConfig.log_to_ram),
+	     BOOL2STR(daemonConfig.use_syslog),
+	     BOOL2STR(daemonConfig.journal),
+	     BOOL2STR(daemonConfig.with_notifications),
+	     BOOL2STR(daemonConfig.with_storage_notifications));
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (!watchConfig[watch_idx].is_active) {
+			continue;
+		}
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Watch config @ index %hhu loaded from our snapshot: filename=%s, action=%s, label=%s",
+		     watch_idx,
+		     watchConfig[watch_idx].filename,
+		     watchConfig[watch_idx].action,
+		     watchConfig[watch_idx].label);
+	}
+	rval = EXIT_SUCCESS;
 
-	return sane;
+cleanup:
+	free(snap);
+	close(fd);
+	return rval;
 }
 
-// Returns the index of the first usable entry in the watch list
-static int8_t
-    get_next_available_watch_entry(void)
+// Store a snapshot of our current config on the rootfs, if the config directory changed since the last one
+static void
+    save_config_snapshot(void)
 {
-	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
-		if (!watchConfig[watch_idx].is_active) {
-			return (int8_t) watch_idx;
+	// If the daemon config changed since we last parsed it, catch up first,
+	// otherwise we'd be pairing the new dir_hash with stale daemon settings.
+	refresh_daemon_config();
+
+	if (isSnapshotInhibited) {
+		return;
+	}
+	uint64_t dir_hash = 0U;
+	if (get_config_dir_hash(&dir_hash) != EXIT_SUCCESS || dir_hash == configSnapshotHash) {
+		return;
+	}
+
+	ConfigSnapshot* snap = calloc(1U, sizeof(*snap));
+	if (!snap) {
+		PFLOG(LOG_WARNING, "calloc: %m");
+		return;
+	}
+	snap->magic    = CONFIG_SNAPSHOT_MAGIC;
+	snap->format   = CONFIG_SNAPSHOT_VERSION;
+	snap->size     = sizeof(*snap);
+	snap->dir_hash    = dir_hash;
+	snap->daemon_hash = daemonConfigHash;
+	str5cpy(snap->version, sizeof(snap->version), KFMON_VERSION, sizeof(snap->version), TRUNC);
+	snap->daemon = daemonConfig;
+	memcpy(snap->watches, watchConfig, sizeof(snap->watches));
+	memcpy(snap->files, configFingerprints, sizeof(snap->files));
+	const size_t payload_offset = offsetof(ConfigSnapshot, daemon);
+	snap->checksum =
+	    fnv1a_update(0xCBF29CE484222325ULL, (const char*) snap + payload_offset, sizeof(*snap) - payload_offset);
+
+	// Make sure we never leave a half-written snapshot behind
+	int fd = open(KFMON_CONFIG_SNAPSHOT ".tmp", O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd == -1) {
+		PFLOG(LOG_WARNING, "open: %m");
+		free(snap);
+		return;
+	}
+	if (write_in_full(fd, snap, sizeof(*snap)) < 0 || fsync(fd) == -1) {
+		PFLOG(LOG_WARNING, "write: %m");
+		close(fd);
+		unlink(KFMON_CONFIG_SNAPSHOT ".tmp");
+		free(snap);
+		return;
+	}
+	close(fd);
+	free(snap);
+
+	if (rename(KFMON_CONFIG_SNAPSHOT ".tmp", KFMON_CONFIG_SNAPSHOT) == -1) {
+		PFLOG(LOG_WARNING, "rename: %m");
+		unlink(KFMON_CONFIG_SNAPSHOT ".tmp");
+		return;
+	}
+	configSnapshotHash = dir_hash;
+	CLOG(LOG_CAT_CONFIG, LOG_INFO, "Updated our config snapshot");
+}
+
+// Re-parse the daemon config, applying whatever can be applied at runtime
+static void
+    reload_daemon_config(void)
+{
+	// Fingerprint the files *before* parsing them, so that a concurrent edit is caught next time around
+	uint64_t daemon_hash = 0U;
+	get_daemon_config_hash(&daemon_hash);
+
+	DaemonConfig cur_config = { 0 };
+	int          ret        = ini_parse(KFMON_CONFIGPATH "/kfmon.ini", daemon_handler, &cur_config);
+	if (ret != 0) {
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_WARNING,
+		     "Failed to parse main config file '%s' (first error on line %d), keeping the current one!",
+		     "kfmon.ini",
+		     ret);
+		return;
+	}
+	const char usercfg_path[] = KFMON_CONFIGPATH "/kfmon.user.ini";
+	if (access(usercfg_path, F_OK) == 0) {
+		ret = ini_parse(usercfg_path, daemon_handler, &cur_config);
+		if (ret != 0) {
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_WARNING,
+			     "Failed to parse user config file '%s' (first error on line %d), keeping the current one!",
+			     "kfmon.user.ini",
+			     ret);
+			return;
 		}
 	}
-	return -1;
+
+	// We've already setup our logging, so that one will have to wait until the next restart.
+	// Which means our snapshot can't be trusted until then, either.
+	if (cur_config.use_syslog != daemonConfig.use_syslog || cur_config.log_to_ram != daemonConfig.log_to_ram) {
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_WARNING,
+		     "use_syslog or log_to_ram were updated, but this will only be honored after a restart!");
+		cur_config.use_syslog = daemonConfig.use_syslog;
+		cur_config.log_to_ram = daemonConfig.log_to_ram;
+		isSnapshotInhibited   = true;
+		unlink(KFMON_CONFIG_SNAPSHOT);
+	}
+	daemonConfig     = cur_config;
+	daemonConfigHash = daemon_hash;
+	apply_log_levels();
+	if (daemonConfig.journal) {
+		journal_open();
+	} else {
+		journal_close();
+	}
+	CLOG(LOG_CAT_CONFIG,
+	     LOG_NOTICE,
+	     "Daemon config reloaded: db_timeout=%hu, queue_ttl=%hu, log_flush=%hu, log_segment_size=%hu, log_segments=%hu, log_compress=%s, log_to_ram=%s, use_syslog=%s, journal=%s, with_notifications=%s, with_storage_notifications=%s",
+	     daemonConfig.db_timeout,
+	     daemonConfig.queue_ttl,
+	     daemonConfig.log_flush,
+	     daemonConfig.log_segment_size,
+	     daemonConfig.log_segments,
+	     BOOL2STR(daemonConfig.log_compress),
+	     BOOL2STR(daemonConfig.log_to_ram),
+	     BOOL2STR(daemonConfig.use_syslog),
+	     BOOL2STR(daemonConfig.journal),
+	     BOOL2STR(daemonConfig.with_notifications),
+	     BOOL2STR(daemonConfig.with_storage_notifications));
 }
 
-// Mimic scandir's alphasort
-static int
-    fts_alphasort(const FTSENT** a, const FTSENT** b)
+// Reload the daemon config if its files changed since we last parsed them
+static void
+    refresh_daemon_config(void)
 {
-	// NOTE: alphasort actually uses strcoll now, but this is Kobo, locales are broken anyway, so, strcmp is The Way.
-	//	 Or strverscmp is we wanted natural sorting, which we don't really need here ;).
-	return strcmp((*a)->fts_name, (*b)->fts_name);
+	uint64_t daemon_hash = 0U;
+	if (get_daemon_config_hash(&daemon_hash) == EXIT_SUCCESS && daemon_hash != daemonConfigHash) {
+		CLOG(LOG_CAT_CONFIG, LOG_NOTICE, "Daemon config files changed, reloading the daemon config");
+		reload_daemon_config();
+	}
+}
+
+// We started from our snapshot before the target was mounted, now that it is, check that it's still accurate.
+// NOTE: Watch configs are handled by update_watch_configs, like after an USBMS session.
+static void
+    revalidate_config(void)
+{
+	isConfigProvisional = false;
+
+	uint64_t dir_hash = 0U;
+	if (get_config_dir_hash(&dir_hash) == EXIT_SUCCESS && dir_hash == configSnapshotHash) {
+		CLOG(LOG_CAT_CONFIG, LOG_INFO, "Our config snapshot is up to date");
+		return;
+	}
+
+	CLOG(LOG_CAT_CONFIG,
+	     LOG_NOTICE,
+	     "Config directory changed since our last snapshot, reloading the daemon config");
+	reload_daemon_config();
 }
 
 // Load our config files...
@@ -760,11 +2633,32 @@ static int
 {
 	// Our config files live in the target mountpoint...
 	if (!is_target_mounted()) {
-		LOG(LOG_NOTICE, "%s isn't mounted, waiting for it to be . . .", KFMON_TARGET_MOUNTPOINT);
+		// ...but our snapshot doesn't, so, if we have one, go with it for now.
+		// It'll be checked against the actual config files once the target is mounted.
+		if (load_config_snapshot(false) == EXIT_SUCCESS) {
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_NOTICE,
+			     "%s isn't mounted yet, starting from our config snapshot",
+			     KFMON_TARGET_MOUNTPOINT);
+			isConfigProvisional = true;
+			return EXIT_SUCCESS;
+		}
+
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "%s isn't mounted, waiting for it to be . . .",
+		     KFMON_TARGET_MOUNTPOINT);
 		// If it's not, wait for it to be...
 		wait_for_target_mountpoint();
 	}
 
+	// If nothing changed since our last snapshot, we don't even need to look at the config files
+	if (load_config_snapshot(true) == EXIT_SUCCESS) {
+		return EXIT_SUCCESS;
+	}
+	// Remember which version of the daemon config files we're about to parse (c.f., save_config_snapshot)
+	get_daemon_config_hash(&daemonConfigHash);
+
 	// Walk the config directory to pickup our ini files... (c.f.,
 	// https://keramida.wordpress.com/2009/07/05/fts3-or-avoiding-to-reinvent-the-wheel/)
 	// We only need to walk a single directory...
@@ -790,7 +2684,10 @@ static int
 	chp = fts_children(ftsp, 0);
 	if (chp == NULL) {
 		// No files to traverse!
-		LOG(LOG_CRIT, "Config directory '%s' appears to be empty, aborting!", KFMON_CONFIGPATH);
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_CRIT,
+		     "Config directory '%s' appears to be empty, aborting!",
+		     KFMON_CONFIGPATH);
 		fts_close(ftsp);
 		return -1;
 	}
@@ -808,7 +2705,10 @@ static int
 				if (p->fts_namelen > 4 &&
 				    strncasecmp(p->fts_name + (p->fts_namelen - 4), ".ini", 4) == 0 &&
 				    strncasecmp(p->fts_name, ".", 1) != 0) {
-					LOG(LOG_INFO, "Trying to load config file '%s' . . .", p->fts_path);
+					CLOG(LOG_CAT_CONFIG,
+					     LOG_INFO,
+					     "Trying to load config file '%s' . . .",
+					     p->fts_path);
 					// The main config has to be parsed slightly differently...
 					if (strcasecmp(p->fts_name, "kfmon.ini") == 0) {
 						// NOTE: Can technically return -1 on file open error,
@@ -816,20 +2716,29 @@ static int
 						//       given the nature of the loop we're in ;).
 						int ret = ini_parse(p->fts_path, daemon_handler, &daemonConfig);
 						if (ret != 0) {
-							LOG(LOG_CRIT,
-							    "Failed to parse main config file '%s' (first error on line %d), will abort!",
-							    p->fts_name,
-							    ret);
+							CLOG(LOG_CAT_CONFIG,
+							     LOG_CRIT,
+							     "Failed to parse main config file '%s' (first error on line %d), will abort!",
+							     p->fts_name,
+							     ret);
 							// Flag as a failure...
 							rval = -1;
 						} else {
-							LOG(LOG_NOTICE,
-							    "Daemon config loaded from '%s': db_timeout=%hu, use_syslog=%s, with_notifications=%s, with_storage_notifications=%s",
-							    p->fts_name,
-							    daemonConfig.db_timeout,
-							    BOOL2STR(daemonConfig.use_syslog),
-							    BOOL2STR(daemonConfig.with_notifications),
-							    BOOL2STR(daemonConfig.with_storage_notifications));
+							CLOG(LOG_CAT_CONFIG,
+							     LOG_NOTICE,
+							     "Daemon config loaded from '%s': db_timeout=%hu, queue_ttl=%hu, log_flush=%hu, log_segment_size=%hu, log_segments=%hu, log_compress=%s, log_to_ram=%s, use_syslog=%s, journal=%s, with_notifications=%s, with_storage_notifications=%s",
+							     p->fts_name,
+							     daemonConfig.db_timeout,
+							     daemonConfig.queue_ttl,
+							     daemonConfig.log_flush,
+							     daemonConfig.log_segment_size,
+							     daemonConfig.log_segments,
+							     BOOL2STR(daemonConfig.log_compress),
+							     BOOL2STR(daemonConfig.log_to_ram),
+							     BOOL2STR(daemonConfig.use_syslog),
+							     BOOL2STR(daemonConfig.journal),
+							     BOOL2STR(daemonConfig.with_notifications),
+							     BOOL2STR(daemonConfig.with_storage_notifications));
 						}
 					} else if (strcasecmp(p->fts_name, "kfmon.user.ini") == 0) {
 						// NOTE: Skip the user config for now,
@@ -840,46 +2749,65 @@ static int
 						// NOTE: Don't blow up when trying to store more watches than we have
 						//       space for...
 						if (watch_count >= WATCH_MAX) {
-							LOG(LOG_WARNING,
-							    "We've already setup the maximum amount of watches we can handle (%d), discarding '%s'!",
-							    WATCH_MAX,
-							    p->fts_name);
+							CLOG(LOG_CAT_CONFIG,
+							     LOG_WARNING,
+							     "We've already setup the maximum amount of watches we can handle (%d), discarding '%s'!",
+							     WATCH_MAX,
+							     p->fts_name);
 							// Don't flag this as a hard failure, just warn and go on...
 							break;
 						}
 
 						// Assume a config is invalid until proven otherwise...
-						bool is_watch_valid = false;
-						int  ret =
-						    ini_parse(p->fts_path, watch_handler, &watchConfig[watch_count]);
+						bool        is_watch_valid = false;
+						// Fingerprint it, so that update_watch_configs can skip it later
+						struct stat st             = { 0 };
+						uint64_t    hash           = 0U;
+						char*       data           = read_config_file(p->fts_path, &st, &hash);
+						int         ret            = -1;
+						if (data) {
+							ret = ini_parse_string(
+							    data, watch_handler, &watchConfig[watch_count]);
+							free(data);
+						}
 						if (ret != 0) {
-							LOG(LOG_WARNING,
-							    "Failed to parse watch config file '%s' (first error on line %d), it will be discarded!",
-							    p->fts_name,
-							    ret);
+							CLOG(LOG_CAT_CONFIG,
+							     LOG_WARNING,
+							     "Failed to parse watch config file '%s' (first error on line %d), it will be discarded!",
+							     p->fts_name,
+							     ret);
 						} else {
 							if (validate_watch_config(&watchConfig[watch_count])) {
-								LOG(LOG_NOTICE,
-								    "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
-								    watch_count,
-								    p->fts_name,
-								    watchConfig[watch_count].filename,
-								    watchConfig[watch_count].action,
-								    watchConfig[watch_count].label,
-								    BOOL2STR(watchConfig[watch_count].hidden),
-								    BOOL2STR(watchConfig[watch_count].block_spawns),
-								    BOOL2STR(watchConfig[watch_count].do_db_update),
-								    watchConfig[watch_count].db_title,
-								    watchConfig[watch_count].db_author,
-								    watchConfig[watch_count].db_comment);
+								CLOG(LOG_CAT_CONFIG,
+								     LOG_NOTICE,
+								     "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, max_runtime=%hu, max_idle=%hu, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+								     watch_count,
+								     p->fts_name,
+								     watchConfig[watch_count].filename,
+								     watchConfig[watch_count].action,
+								     watchConfig[watch_count].label,
+								     BOOL2STR(watchConfig[watch_count].hidden),
+								     BOOL2STR(watchConfig[watch_count].block_spawns),
+								     watchConfig[watch_count].max_runtime,
+								     watchConfig[watch_count].max_idle,
+								     BOOL2STR(watchConfig[watch_count].do_db_update),
+								     watchConfig[watch_count].db_title,
+								     watchConfig[watch_count].db_author,
+								     watchConfig[watch_count].db_comment);
 
 								is_watch_valid = true;
 							} else {
-								LOG(LOG_WARNING,
-								    "Watch config file '%s' is not valid, it will be discarded!",
-								    p->fts_name);
+								CLOG(LOG_CAT_CONFIG,
+								     LOG_WARNING,
+								     "Watch config file '%s' is not valid, it will be discarded!",
+								     p->fts_name);
 							}
 						}
+						if (ret != -1) {
+							ConfigFingerprint* fp     = get_config_fingerprint(p->fts_name);
+							int8_t             fp_idx = is_watch_valid ? (int8_t) watch_count : -1;
+							update_config_fingerprint(fp, &st, hash, fp_idx, ret != 0);
+						}
 						// If the watch config is valid, mark it as active, and increment the active count.
 						// Otherwise, clear the slot so it can be reused.
 						if (is_watch_valid) {
@@ -901,33 +2829,49 @@ static int
 	if (access(usercfg_path, F_OK) == 0) {
 		int ret = ini_parse(usercfg_path, daemon_handler, &daemonConfig);
 		if (ret != 0) {
-			LOG(LOG_CRIT,
-			    "Failed to parse user config file '%s' (first error on line %d), will abort!",
-			    "kfmon.user.ini",
-			    ret);
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_CRIT,
+			     "Failed to parse user config file '%s' (first error on line %d), will abort!",
+			     "kfmon.user.ini",
+			     ret);
 			// Flag as a failure...
 			rval = -1;
 		} else {
-			LOG(LOG_NOTICE,
-			    "Daemon config loaded from '%s': db_timeout=%hu, use_syslog=%s, with_notifications=%s, with_storage_notifications=%s",
-			    "kfmon.user.ini",
-			    daemonConfig.db_timeout,
-			    BOOL2STR(daemonConfig.use_syslog),
-			    BOOL2STR(daemonConfig.with_notifications),
-			    BOOL2STR(daemonConfig.with_storage_notifications));
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_NOTICE,
+			     "Daemon config loaded from '%s': db_timeout=%hu, queue_ttl=%hu, log_flush=%hu, log_segment_size=%hu, log_segments=%hu, log_compress=%s, log_to_ram=%s, use_syslog=%s, journal=%s, with_notifications=%s, with_storage_notifications=%s",
+			     "kfmon.user.ini",
+			     daemonConfig.db_timeout,
+			     daemonConfig.queue_ttl,
+			     daemonConfig.log_flush,
+			     daemonConfig.log_segment_size,
+			     daemonConfig.log_segments,
+			     BOOL2STR(daemonConfig.log_compress),
+			     BOOL2STR(daemonConfig.log_to_ram),
+			     BOOL2STR(daemonConfig.use_syslog),
+			     BOOL2STR(daemonConfig.journal),
+			     BOOL2STR(daemonConfig.with_notifications),
+			     BOOL2STR(daemonConfig.with_storage_notifications));
 		}
 	}
 
 #ifdef DEBUG
 	// Let's recap (including failures)...
-	DBGLOG("Daemon config recap: db_timeout=%hu, use_syslog=%s, with_notifications=%s, with_storage_notifications=%s",
+	DBGLOG("Daemon config recap: db_timeout=%hu, queue_ttl=%hu, log_flush=%hu, log_segment_size=%hu, log_segments=%hu, log_compress=%s, log_to_ram=%s, use_syslog=%s, journal=%s, with_notifications=%s, with_storage_notifications=%s",
 	       daemonConfig.db_timeout,
+	       daemonConfig.queue_ttl,
+	       daemonConfig.log_flush,
+	       daemonConfig.log_segment_size,
+	       daemonConfig.log_segments,
+	       BOOL2STR(daemonConfig.log_compress),
+	       BOOL2STR(daemonConfig.log_to_ram),
 	       BOOL2STR(daemonConfig.use_syslog),
+	       BOOL2STR(daemonConfig.journal),
 	       BOOL2STR(daemonConfig.with_notifications),
 	       BOOL2STR(daemonConfig.with_storage_notifications));
 	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
 		DBGLOG(
-		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, max_runtime=%hu, max_idle=%hu, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
 		    watch_idx,
 		    BOOL2STR(watchConfig[watch_idx].is_active),
 		    watchConfig[watch_idx].filename,
@@ -935,6 +2879,8 @@ static int
 		    watchConfig[watch_idx].label,
 		    BOOL2STR(watchConfig[watch_idx].hidden),
 		    BOOL2STR(watchConfig[watch_idx].block_spawns),
+		    watchConfig[watch_idx].max_runtime,
+		    watchConfig[watch_idx].max_idle,
 		    BOOL2STR(watchConfig[watch_idx].skip_db_checks),
 		    BOOL2STR(watchConfig[watch_idx].do_db_update),
 		    watchConfig[watch_idx].db_title,
@@ -943,9 +2889,317 @@ static int
 	}
 #endif
 
+	// Snapshot all that for next time
+	if (rval == EXIT_SUCCESS) {
+		save_config_snapshot();
+	}
+
 	return rval;
 }
 
+// Is that a watch config file?
+// (i.e., an .ini that's neither an unix hidden file, a Mac resource fork, nor our main config)
+static bool
+    is_watch_config_name(const char* name)
+{
+	size_t len = strlen(name);
+	if (len <= 4U || strncasecmp(name + (len - 4U), ".ini", 4U) != 0 || name[0] == '.') {
+		return false;
+	}
+
+	return strcasecmp(name, "kfmon.ini") != 0 && strcasecmp(name, "kfmon.user.ini") != 0;
+}
+
+// Drop an active watch, and let everyone know about it
+static void
+    release_watch(uint8_t watch_idx)
+{
+	FB_PRINTF("[KFMon] Dropped the watch on %s!", basename(watchConfig[watch_idx].filename));
+	publish_watch_event("watch-removed", watch_idx);
+	invalidate_watch_lists();
+
+	// Don't keep the previous state around, clear the slot.
+	watchConfig[watch_idx] = (const WatchConfig) { 0 };
+	forget_config_fingerprints(watch_idx);
+	CLOG(LOG_CAT_CONFIG, LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
+}
+
+// There were meaningful updates, update the IPC socket's mtime as a hint to clients that new data is available.
+static void
+    notify_watch_update(void)
+{
+	// Leave atime alone, update mtime to now
+	const struct timespec times[2] = {
+		{ 0, UTIME_OMIT },
+                { 0,  UTIME_NOW }
+	};
+	if (utimensat(0, KFMON_IPC_SOCKET, times, 0) == -1) {
+		PFLOG(LOG_WARNING, "utimensat: %m");
+	}
+}
+
+// Check a single watch config file for changes, and apply them.
+// st may be NULL if we don't have its stat data handy, in which case it'll always be read & hashed.
+// Returns the watch slot it now backs (-1 if none), and flags whether it was skipped because it hadn't changed.
+static int8_t
+    check_watch_config_file(const char*        path,
+			    const char*        name,
+			    const struct stat* cur_st,
+			    bool*              notify_update,
+			    bool*              was_skipped)
+{
+	ConfigFingerprint* fp = get_config_fingerprint(name);
+	if (fp) {
+		fp->is_seen = true;
+		// If it had gone away, it's back (c.f., drop_gone_configs)
+		fp->is_gone = false;
+	}
+
+	// Only read it if its stat data doesn't vouch for it
+	bool        is_unchanged = fp && cur_st && is_config_unchanged(fp, cur_st);
+	struct stat st           = { 0 };
+	uint64_t    hash         = 0U;
+	char*       data         = NULL;
+	if (!is_unchanged) {
+		data = read_config_file(path, &st, &hash);
+		// Same contents (e.g., it was touched, or copied over again)
+		is_unchanged = data && fp && fp->checked_at != 0 && fp->size == st.st_size && fp->hash == hash;
+	}
+
+	// Unchanged configs can be skipped if they're still backing an active watch, or if they're broken beyond repair.
+	// Otherwise (i.e., it was discarded because of a conflict with another config,
+	// or because we were out of watch slots), give it another shot.
+	if (is_unchanged) {
+		bool is_skippable = false;
+		if (fp->watch_idx >= 0 && watchConfig[fp->watch_idx].is_active) {
+			is_skippable = true;
+		} else if (fp->is_broken) {
+			is_skippable = true;
+		}
+
+		if (is_skippable) {
+			if (data) {
+				update_config_fingerprint(fp, &st, hash, fp->watch_idx, fp->is_broken);
+				free(data);
+			}
+			*was_skipped = true;
+			return fp->is_broken ? -1 : fp->watch_idx;
+		}
+
+		if (!data) {
+			data = read_config_file(path, &st, &hash);
+		}
+	}
+
+	CLOG(LOG_CAT_CONFIG, LOG_INFO, "Checking watch config file '%s' for changes . . .", path);
+
+	// Store the results in a temporary struct, so we can compare it to our current watches...
+	WatchConfig cur_watch = { 0 };
+
+	int ret = -1;
+	if (data) {
+		ret = ini_parse_string(data, watch_handler, &cur_watch);
+		free(data);
+	}
+	if (ret != 0) {
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_WARNING,
+		     "Failed to parse watch config file '%s' (first error on line %d), it will be discarded!",
+		     name,
+		     ret);
+		if (ret != -1) {
+			update_config_fingerprint(fp, &st, hash, -1, true);
+		}
+		return -1;
+	}
+
+	// Try to match it to a current watch, based on the trigger file...
+	uint8_t watch_idx    = 0U;
+	bool    is_new_watch = true;
+	for (watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		// Only check active watches
+		if (!watchConfig[watch_idx].is_active) {
+			continue;
+		}
+
+		if (strcmp(cur_watch.filename, watchConfig[watch_idx].filename) == 0) {
+			// Gotcha!
+			is_new_watch = false;
+			// And we're good!
+			break;
+		}
+	}
+
+	if (is_new_watch) {
+		// New watch! Make it so!
+		int8_t new_watch_idx = get_next_available_watch_entry();
+		if (new_watch_idx < 0) {
+			// Discard it if we already have the maximum amount of watches set up
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_WARNING,
+			     "Can't find an available watch slot for '%s', probably because we've already setup the maximum amount of watches we can handle (%d), discarding it!",
+			     name,
+			     WATCH_MAX);
+			update_config_fingerprint(fp, &st, hash, -1, false);
+			return -1;
+		}
+
+		watch_idx              = (uint8_t) new_watch_idx;
+		watchConfig[watch_idx] = cur_watch;
+
+		if (!validate_watch_config(&watchConfig[watch_idx])) {
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_WARNING,
+			     "New watch config file '%s' is not valid, it will be discarded!",
+			     name);
+
+			// Clear the slot
+			watchConfig[watch_idx] = (const WatchConfig) { 0 };
+			update_config_fingerprint(fp, &st, hash, -1, false);
+			return -1;
+		}
+
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_NOTICE,
+		     "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, max_runtime=%hu, max_idle=%hu, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+		     watch_idx,
+		     name,
+		     watchConfig[watch_idx].filename,
+		     watchConfig[watch_idx].action,
+		     watchConfig[watch_idx].label,
+		     BOOL2STR(watchConfig[watch_idx].hidden),
+		     BOOL2STR(watchConfig[watch_idx].block_spawns),
+		     watchConfig[watch_idx].max_runtime,
+		     watchConfig[watch_idx].max_idle,
+		     BOOL2STR(watchConfig[watch_idx].do_db_update),
+		     watchConfig[watch_idx].db_title,
+		     watchConfig[watch_idx].db_author,
+		     watchConfig[watch_idx].db_comment);
+
+		// Flag it as active
+		watchConfig[watch_idx].is_active  = true;
+		// It doesn't have an inotify watch yet
+		watchConfig[watch_idx].inotify_wd = -1;
+		update_config_fingerprint(fp, &st, hash, (int8_t) watch_idx, false);
+
+		FB_PRINTF("[KFMon] Setup a new watch on %s", basename(watchConfig[watch_idx].filename));
+
+		// New stuff!
+		*notify_update = true;
+		publish_watch_event("watch-added", watch_idx);
+		invalidate_watch_lists();
+		return (int8_t) watch_idx;
+	}
+
+	// Updated watch!
+	pthread_mutex_lock(&ptlock);
+	bool is_watch_spawned = is_watch_already_spawned(watch_idx);
+	pthread_mutex_unlock(&ptlock);
+	// Don't do anything if it's already running...
+	if (is_watch_spawned) {
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_INFO,
+		     "Cannot update watch slot %hhu (%s => %s), as it's currently running! Discarding potentially new data from '%s'!",
+		     watch_idx,
+		     basename(watchConfig[watch_idx].filename),
+		     basename(watchConfig[watch_idx].action),
+		     name);
+
+		// Don't forget to flag it as a keeper, and to look at it again next time.
+		if (fp) {
+			fp->checked_at = 0;
+		}
+		return (int8_t) watch_idx;
+	}
+
+	bool was_updated = false;
+	// Validate what was parsed, and merge it if it's sane!
+	if (!validate_and_merge_watch_config(&cur_watch, watch_idx, &was_updated)) {
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_CRIT,
+		     "Updated watch config file '%s' is not valid, it will be discarded!",
+		     name);
+
+		release_watch(watch_idx);
+		update_config_fingerprint(fp, &st, hash, -1, false);
+
+		// Less stuff!
+		*notify_update = true;
+		return -1;
+	}
+
+	// NOTE: validate_and_merge takes care of both logging and updating the watch data
+	update_config_fingerprint(fp, &st, hash, (int8_t) watch_idx, false);
+
+	// Updated stuff!
+	if (was_updated) {
+		*notify_update = true;
+		publish_watch_event("watch-updated", watch_idx);
+		invalidate_watch_lists();
+	}
+	return (int8_t) watch_idx;
+}
+
+// Setup the inotify watch for that watch's target file
+static void
+    add_target_watch(int fd, uint8_t watch_idx)
+{
+	watchConfig[watch_idx].inotify_wd = inotify_add_watch(fd, watchConfig[watch_idx].filename, IN_OPEN | IN_CLOSE);
+	if (watchConfig[watch_idx].inotify_wd == -1) {
+		// NOTE: Allow running without an actual inotify watch, keeping the action IPC only...
+		//       We could limit this behavior to !hidden watches, or hide it behind another config flag,
+		//       but it's harmless enough to do it unconditionally ;).
+		//       The watch will be released properly if the *config* file gets removed.
+		if (errno == ENOENT) {
+			// Only account for ENOENT, though ;) (i.e., filename is gone).
+			CLOG(LOG_CAT_EVENTS,
+			     LOG_NOTICE,
+			     "Setup an IPC-only watch for '%s' @ index %hhu.",
+			     basename(watchConfig[watch_idx].filename),
+			     watch_idx);
+		} else {
+			PFLOG(LOG_WARNING, "inotify_add_watch: %m");
+			CLOG(LOG_CAT_EVENTS,
+			     LOG_WARNING,
+			     "Cannot watch '%s', discarding it!",
+			     watchConfig[watch_idx].filename);
+			FB_PRINTF("[KFMon] Failed to watch %s!", basename(watchConfig[watch_idx].filename));
+			// NOTE: We used to abort entirely in case even one target file couldn't be watched,
+			//       but that was a bit harsh ;).
+			//       Since the inotify watch couldn't be setup,
+			//       there's no way for this to cause trouble down the road,
+			//       and this allows the user to fix it during an USBMS session,
+			//       instead of having to reboot.
+
+			// If that watch isn't currently running, clear it entirely!
+			pthread_mutex_lock(&ptlock);
+			bool is_watch_spawned = is_watch_already_spawned(watch_idx);
+			pthread_mutex_unlock(&ptlock);
+			if (is_watch_spawned) {
+				CLOG(LOG_CAT_EVENTS,
+				     LOG_WARNING,
+				     "Cannot release watch slot %hhu (%s => %s), as it's currently running!",
+				     watch_idx,
+				     basename(watchConfig[watch_idx].filename),
+				     basename(watchConfig[watch_idx].action));
+			} else {
+				publish_watch_event("watch-removed", watch_idx);
+				invalidate_watch_lists();
+				watchConfig[watch_idx] = (const WatchConfig) { 0 };
+				// NOTE: This should essentially come down to:
+				//memset(&watchConfig[watch_idx], 0, sizeof(WatchConfig));
+				CLOG(LOG_CAT_EVENTS, LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
+			}
+		}
+	} else {
+		CLOG(LOG_CAT_EVENTS,
+		     LOG_NOTICE,
+		     "Setup an inotify watch for '%s' @ index %hhu.",
+		     watchConfig[watch_idx].filename,
+		     watch_idx);
+	}
+}
+
 // Check if watch configs have been added/removed/updated...
 static int
     update_watch_configs(void)
@@ -961,10 +3215,10 @@ static int
 	char* const cfg_path[] = { KFMON_CONFIGPATH, NULL };
 #pragma GCC diagnostic pop
 
-	// Don't chdir (because that mountpoint can go buh-bye), and don't stat (because we don't need to).
+	// Don't chdir (because that mountpoint can go buh-bye).
+	// NOTE: We *do* need the stat data, as that's what tells us whether a config file has changed or not.
 	FTS* restrict ftsp;
-	if ((ftsp = fts_open(
-		 cfg_path, FTS_COMFOLLOW | FTS_LOGICAL | FTS_NOCHDIR | FTS_NOSTAT | FTS_XDEV, &fts_alphasort)) == NULL) {
+	if ((ftsp = fts_open(cfg_path, FTS_COMFOLLOW | FTS_LOGICAL | FTS_NOCHDIR | FTS_XDEV, &fts_alphasort)) == NULL) {
 		PFLOG(LOG_CRIT, "fts_open: %m");
 		return -1;
 	}
@@ -973,7 +3227,10 @@ static int
 	chp = fts_children(ftsp, 0);
 	if (chp == NULL) {
 		// No files to traverse!
-		LOG(LOG_CRIT, "Config directory '%s' appears to be empty, aborting!", KFMON_CONFIGPATH);
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_CRIT,
+		     "Config directory '%s' appears to be empty, aborting!",
+		     KFMON_CONFIGPATH);
 		fts_close(ftsp);
 		return -1;
 	}
@@ -984,169 +3241,31 @@ static int
 	uint8_t new_watch_count           = 0U;
 	// If there was a meaningful update, we'll update the IPC socket's mtime as a hint to clients that new data is available.
 	bool    notify_update             = false;
+	// Keep track of how many configs we could skip
+	uint8_t unchanged_count           = 0U;
+
+	// Figure out which config files are gone after the walk
+	for (uint8_t i = 0U; i < CONFIG_FILES_MAX; i++) {
+		configFingerprints[i].is_seen = false;
+	}
 
 	FTSENT* restrict p;
 	while ((p = fts_read(ftsp)) != NULL) {
 		switch (p->fts_info) {
 			case FTS_F:
 				// Check if it's a .ini and not either an unix hidden file or a Mac resource fork...
-				if (p->fts_namelen > 4 &&
-				    strncasecmp(p->fts_name + (p->fts_namelen - 4), ".ini", 4) == 0 &&
-				    strncasecmp(p->fts_name, ".", 1) != 0) {
-					// NOTE: We only care about *watch* configs,
-					//       the main config is only loaded at startup
-					//       This is mainly to keep our fd shenanigans sane,
-					//       which would get a bit hairier
-					//       if we needed to be able to toggle syslog usage...
-					if (strcasecmp(p->fts_name, "kfmon.ini") == 0) {
-						continue;
-					} else if (strcasecmp(p->fts_name, "kfmon.user.ini") == 0) {
-						continue;
-					} else {
-						LOG(LOG_INFO,
-						    "Checking watch config file '%s' for changes . . .",
-						    p->fts_path);
-
-						// Store the results in a temporary struct,
-						// so we can compare it to our current watches...
-						WatchConfig cur_watch = { 0 };
-
-						int ret = ini_parse(p->fts_path, watch_handler, &cur_watch);
-						if (ret != 0) {
-							LOG(LOG_WARNING,
-							    "Failed to parse watch config file '%s' (first error on line %d), it will be discarded!",
-							    p->fts_name,
-							    ret);
-						} else {
-							// Try to match it to a current watch, based on the trigger file...
-							uint8_t watch_idx    = 0U;
-							bool    is_new_watch = true;
-							for (watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
-								// Only check active watches
-								if (!watchConfig[watch_idx].is_active) {
-									continue;
-								}
-
-								if (strcmp(cur_watch.filename,
-									   watchConfig[watch_idx].filename) == 0) {
-									// Gotcha!
-									is_new_watch = false;
-									// And we're good!
-									break;
-								}
-							}
-
-							if (is_new_watch) {
-								// New watch! Make it so!
-								int8_t new_watch_idx = get_next_available_watch_entry();
-								if (new_watch_idx < 0) {
-									// Discard it if we already have the maximum amount of watches set up
-									LOG(LOG_WARNING,
-									    "Can't find an available watch slot for '%s', probably because we've already setup the maximum amount of watches we can handle (%d), discarding it!",
-									    p->fts_name,
-									    WATCH_MAX);
-								} else {
-									watch_idx              = (uint8_t) new_watch_idx;
-									watchConfig[watch_idx] = cur_watch;
-
-									if (validate_watch_config(
-										&watchConfig[watch_idx])) {
-										LOG(LOG_NOTICE,
-										    "Watch config @ index %hhu loaded from '%s': filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
-										    watch_idx,
-										    p->fts_name,
-										    watchConfig[watch_idx].filename,
-										    watchConfig[watch_idx].action,
-										    watchConfig[watch_idx].label,
-										    BOOL2STR(
-											watchConfig[watch_idx].hidden),
-										    BOOL2STR(watchConfig[watch_idx]
-												 .block_spawns),
-										    BOOL2STR(watchConfig[watch_idx]
-												 .do_db_update),
-										    watchConfig[watch_idx].db_title,
-										    watchConfig[watch_idx].db_author,
-										    watchConfig[watch_idx].db_comment);
-
-										// Flag it as active
-										watchConfig[watch_idx].is_active = true;
-										new_watch_list[new_watch_count++] =
-										    (int8_t) watch_idx;
-
-										FB_PRINTF(
-										    "[KFMon] Setup a new watch on %s",
-										    basename(
-											watchConfig[watch_idx].filename));
-
-										// New stuff!
-										notify_update = true;
-									} else {
-										LOG(LOG_WARNING,
-										    "New watch config file '%s' is not valid, it will be discarded!",
-										    p->fts_name);
-
-										// Clear the slot
-										watchConfig[watch_idx] =
-										    (const WatchConfig) { 0 };
-									}
-								}
-							} else {
-								// Updated watch!
-								pthread_mutex_lock(&ptlock);
-								bool is_watch_spawned =
-								    is_watch_already_spawned(watch_idx);
-								pthread_mutex_unlock(&ptlock);
-								// Don't do anything if it's already running...
-								if (is_watch_spawned) {
-									LOG(LOG_INFO,
-									    "Cannot update watch slot %hhu (%s => %s), as it's currently running! Discarding potentially new data from '%s'!",
-									    watch_idx,
-									    basename(watchConfig[watch_idx].filename),
-									    basename(watchConfig[watch_idx].action),
-									    p->fts_name);
-
-									// Don't forget to flag it as a keeper...
-									new_watch_list[new_watch_count++] =
-									    (int8_t) watch_idx;
-								} else {
-									bool was_updated = false;
-									// Validate what was parsed, and merge it if it's sane!
-									if (validate_and_merge_watch_config(
-										&cur_watch, watch_idx, &was_updated)) {
-										// NOTE: validate_and_merge takes care of both
-										//       logging and updating the watch data
-										new_watch_list[new_watch_count++] =
-										    (int8_t) watch_idx;
-
-										// Updated stuff!
-										if (was_updated) {
-											notify_update = true;
-										}
-
-									} else {
-										LOG(LOG_CRIT,
-										    "Updated watch config file '%s' is not valid, it will be discarded!",
-										    p->fts_name);
-
-										FB_PRINTF(
-										    "[KFMon] Dropped the watch on %s!",
-										    basename(
-											watchConfig[watch_idx].filename));
-
-										// Don't keep the previous state around,
-										// clear the slot.
-										watchConfig[watch_idx] =
-										    (const WatchConfig) { 0 };
-										LOG(LOG_NOTICE,
-										    "Released watch slot %hhu.",
-										    watch_idx);
-
-										// Less stuff!
-										notify_update = true;
-									}
-								}
-							}
-						}
+				// NOTE: We only care about *watch* configs here,
+				//       the daemon config is handled by refresh_daemon_config
+				//       (via save_config_snapshot).
+				if (is_watch_config_name(p->fts_name)) {
+					bool   was_skipped = false;
+					int8_t watch_idx   = check_watch_config_file(
+					    p->fts_path, p->fts_name, p->fts_statp, &notify_update, &was_skipped);
+					if (watch_idx >= 0) {
+						new_watch_list[new_watch_count++] = watch_idx;
+					}
+					if (was_skipped) {
+						unchanged_count++;
 					}
 				}
 				break;
@@ -1156,6 +3275,16 @@ static int
 	}
 	fts_close(ftsp);
 
+	// Forget about config files that are gone, their watches will be purged below
+	for (uint8_t i = 0U; i < CONFIG_FILES_MAX; i++) {
+		if (configFingerprints[i].name[0] != '\0' && !configFingerprints[i].is_seen) {
+			configFingerprints[i] = (const ConfigFingerprint) { 0 };
+		}
+	}
+	if (unchanged_count > 0U) {
+		CLOG(LOG_CAT_CONFIG, LOG_INFO, "Skipped %hhu unchanged watch config files", unchanged_count);
+	}
+
 	// Purge stale watch entries (in case a config has been deleted, but not its watched file;
 	// or if an existing config file was updated, but failed to pass watch_handler @ ini_parse).
 	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
@@ -1175,55 +3304,232 @@ static int
 
 		// It's stale, drop it now
 		if (!keep) {
-			LOG(LOG_WARNING,
-			    "Watch config @ index %hhu (%s => %s) is still active, but its config file is either gone or broken! Discarding it!",
-			    watch_idx,
-			    basename(watchConfig[watch_idx].filename),
-			    basename(watchConfig[watch_idx].action));
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_WARNING,
+			     "Watch config @ index %hhu (%s => %s) is still active, but its config file is either gone or broken! Discarding it!",
+			     watch_idx,
+			     basename(watchConfig[watch_idx].filename),
+			     basename(watchConfig[watch_idx].action));
+
+			release_watch(watch_idx);
+
+			// Stale stuff!
+			notify_update = true;
+		}
+	}
+
+	// There were meaningful updates, update the IPC socket's mtime!
+	if (notify_update) {
+		notify_watch_update();
+	}
+
+#ifdef DEBUG
+	// Let's recap (including failures)...
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		DBGLOG(
+		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, max_runtime=%hu, max_idle=%hu, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
+		    watch_idx,
+		    BOOL2STR(watchConfig[watch_idx].is_active),
+		    watchConfig[watch_idx].filename,
+		    watchConfig[watch_idx].action,
+		    watchConfig[watch_idx].label,
+		    BOOL2STR(watchConfig[watch_idx].hidden),
+		    BOOL2STR(watchConfig[watch_idx].block_spawns),
+		    watchConfig[watch_idx].max_runtime,
+		    watchConfig[watch_idx].max_idle,
+		    BOOL2STR(watchConfig[watch_idx].skip_db_checks),
+		    BOOL2STR(watchConfig[watch_idx].do_db_update),
+		    watchConfig[watch_idx].db_title,
+		    watchConfig[watch_idx].db_author,
+		    watchConfig[watch_idx].db_comment);
+	}
+#endif
+
+	// Keep our snapshot in sync
+	save_config_snapshot();
+
+	return 0;
+}
+
+// Apply a change to a single watch config file, as reported by our inotify watch on the config directory.
+// NOTE: Unlike update_watch_configs, only the inotify watches of the affected watch slots are touched.
+static void
+    handle_config_event(int fd, const struct inotify_event* event)
+{
+	if (event->len == 0U) {
+		return;
+	}
+	// The daemon config is applied as a whole (c.f., reload_daemon_config)
+	if (strcasecmp(event->name, "kfmon.ini") == 0 || strcasecmp(event->name, "kfmon.user.ini") == 0) {
+		refresh_daemon_config();
+		save_config_snapshot();
+		return;
+	}
+	if (!is_watch_config_name(event->name)) {
+		return;
+	}
+
+	ConfigFingerprint* fp = get_config_fingerprint(event->name);
+	if (!fp) {
+		CLOG(LOG_CAT_CONFIG,
+		     LOG_WARNING,
+		     "Too many watch config files to keep track of '%s', deferring to the next remount!",
+		     event->name);
+		return;
+	}
+	int8_t old_watch_idx = fp->watch_idx;
+	int    old_wd        = old_watch_idx >= 0 ? watchConfig[old_watch_idx].inotify_wd : -1;
+	bool   notify_update = false;
+
+	if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+		// NOTE: Don't drop its watch just yet: it may be an editor saving it by renaming the original away,
+		//       and said watch may also still be running. drop_gone_configs will deal with it.
+		if (old_watch_idx >= 0 && watchConfig[old_watch_idx].is_active) {
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_NOTICE,
+			     "Watch config file '%s' is gone, its watch will be dropped unless it comes back",
+			     event->name);
+			fp->is_gone = true;
+			clock_gettime(CLOCK_MONOTONIC_RAW, &fp->gone_deadline);
+			fp->gone_deadline.tv_sec  += CONFIG_GONE_DELAY / 1000;
+			fp->gone_deadline.tv_nsec += (CONFIG_GONE_DELAY % 1000) * 1000000L;
+			if (fp->gone_deadline.tv_nsec >= 1000000000L) {
+				fp->gone_deadline.tv_sec++;
+				fp->gone_deadline.tv_nsec -= 1000000000L;
+			}
+		} else {
+			CLOG(LOG_CAT_CONFIG, LOG_NOTICE, "Watch config file '%s' is gone", event->name);
+			*fp = (const ConfigFingerprint) { 0 };
+		}
+	} else {
+		char path[PATH_MAX] = { 0 };
+		snprintf(path, sizeof(path), "%s/%s", KFMON_CONFIGPATH, event->name);
+
+		bool   was_skipped = false;
+		int8_t watch_idx   = check_watch_config_file(path, event->name, NULL, &notify_update, &was_skipped);
+		if (was_skipped) {
+			CLOG(LOG_CAT_CONFIG, LOG_INFO, "Watch config file '%s' hasn't actually changed", event->name);
+		}
+
+		// If it used to back another watch (e.g., its filename changed), that one is now stale
+		if (old_watch_idx >= 0 && old_watch_idx != watch_idx) {
+			if (watchConfig[old_watch_idx].is_active) {
+				bool is_claimed = false;
+				for (uint8_t i = 0U; i < CONFIG_FILES_MAX; i++) {
+					if (configFingerprints[i].watch_idx == old_watch_idx) {
+						is_claimed = true;
+						break;
+					}
+				}
+				pthread_mutex_lock(&ptlock);
+				bool is_watch_spawned = is_watch_already_spawned((uint8_t) old_watch_idx);
+				pthread_mutex_unlock(&ptlock);
+				if (!is_claimed && is_watch_spawned) {
+					// Leave it be, it'll be purged on the next remount (c.f., update_watch_configs)
+					CLOG(LOG_CAT_CONFIG,
+					     LOG_INFO,
+					     "Watch config @ index %hhu (%s => %s) is no longer backed by '%s', but it's currently running! Keeping it until the next remount.",
+					     old_watch_idx,
+					     basename(watchConfig[old_watch_idx].filename),
+					     basename(watchConfig[old_watch_idx].action),
+					     event->name);
+				} else if (!is_claimed) {
+					CLOG(LOG_CAT_CONFIG,
+					     LOG_WARNING,
+					     "Watch config @ index %hhu (%s => %s) is no longer backed by '%s'! Discarding it!",
+					     old_watch_idx,
+					     basename(watchConfig[old_watch_idx].filename),
+					     basename(watchConfig[old_watch_idx].action),
+					     event->name);
+					release_watch((uint8_t) old_watch_idx);
+					notify_update = true;
+				}
+			}
+			// Either way, if the slot is gone, so is its inotify watch
+			if (!watchConfig[old_watch_idx].is_active && old_wd != -1) {
+				if (inotify_rm_watch(fd, old_wd) == -1) {
+					PFLOG(LOG_WARNING, "inotify_rm_watch: %m");
+				}
+			}
+		}
+
+		// Brand new watch, set it up
+		if (watch_idx >= 0 && watch_idx != old_watch_idx && watchConfig[watch_idx].inotify_wd == -1) {
+			add_target_watch(fd, (uint8_t) watch_idx);
+		}
+	}
+
+	if (notify_update) {
+		notify_watch_update();
+	}
+	// Keep our snapshot in sync
+	save_config_snapshot();
+}
 
-			FB_PRINTF("[KFMon] Dropped the watch on %s!", basename(watchConfig[watch_idx].filename));
+// Drop the watches of the config files that went away (c.f., handle_config_event), and stayed gone.
+// Returns how long (in ms) until the next one is due (-1 if none are pending).
+static int
+    drop_gone_configs(int fd)
+{
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	int  timeout       = -1;
+	bool was_dropped   = false;
+	bool notify_update = false;
+	fb_begin_batch();
+	for (uint8_t i = 0U; i < CONFIG_FILES_MAX; i++) {
+		ConfigFingerprint* fp = &configFingerprints[i];
+		if (fp->name[0] == '\0' || !fp->is_gone) {
+			continue;
+		}
+
+		long long int remaining = (fp->gone_deadline.tv_sec - now.tv_sec) * 1000LL +
+					  (fp->gone_deadline.tv_nsec - now.tv_nsec) / 1000000L;
+		if (remaining > 0) {
+			if (timeout == -1 || remaining < timeout) {
+				timeout = (int) remaining;
+			}
+			continue;
+		}
 
-			watchConfig[watch_idx] = (const WatchConfig) { 0 };
-			LOG(LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
+		int8_t watch_idx = fp->watch_idx;
+		if (watch_idx >= 0 && watchConfig[watch_idx].is_active) {
+			pthread_mutex_lock(&ptlock);
+			bool is_watch_spawned = is_watch_already_spawned((uint8_t) watch_idx);
+			pthread_mutex_unlock(&ptlock);
+			// NOTE: We'll be back when it exits (c.f., queue_efd), as the reaper might still need its slot.
+			if (is_watch_spawned) {
+				continue;
+			}
 
-			// Stale stuff!
+			CLOG(LOG_CAT_CONFIG,
+			     LOG_NOTICE,
+			     "Watch config file '%s' is still gone, discarding watch slot %hhu (%s => %s)",
+			     fp->name,
+			     watch_idx,
+			     basename(watchConfig[watch_idx].filename),
+			     basename(watchConfig[watch_idx].action));
+			if (watchConfig[watch_idx].inotify_wd != -1 &&
+			    inotify_rm_watch(fd, watchConfig[watch_idx].inotify_wd) == -1) {
+				PFLOG(LOG_WARNING, "inotify_rm_watch: %m");
+			}
+			release_watch((uint8_t) watch_idx);
 			notify_update = true;
 		}
+		*fp         = (const ConfigFingerprint) { 0 };
+		was_dropped = true;
 	}
+	fb_end_batch();
 
-	// There were meaningful updates, update the IPC socket's mtime!
 	if (notify_update) {
-		// Leave atime alone, update mtime to now
-		const struct timespec times[2] = {
-			{ 0, UTIME_OMIT },
-                        { 0,  UTIME_NOW }
-		};
-		if (utimensat(0, KFMON_IPC_SOCKET, times, 0) == -1) {
-			PFLOG(LOG_WARNING, "utimensat: %m");
-		}
+		notify_watch_update();
 	}
-
-#ifdef DEBUG
-	// Let's recap (including failures)...
-	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
-		DBGLOG(
-		    "Watch config @ index %hhu recap: active=%s, filename=%s, action=%s, label=%s, hidden=%s, block_spawns=%s, skip_db_checks=%s, do_db_update=%s, db_title=%s, db_author=%s, db_comment=%s",
-		    watch_idx,
-		    BOOL2STR(watchConfig[watch_idx].is_active),
-		    watchConfig[watch_idx].filename,
-		    watchConfig[watch_idx].action,
-		    watchConfig[watch_idx].label,
-		    BOOL2STR(watchConfig[watch_idx].hidden),
-		    BOOL2STR(watchConfig[watch_idx].block_spawns),
-		    BOOL2STR(watchConfig[watch_idx].skip_db_checks),
-		    BOOL2STR(watchConfig[watch_idx].do_db_update),
-		    watchConfig[watch_idx].db_title,
-		    watchConfig[watch_idx].db_author,
-		    watchConfig[watch_idx].db_comment);
+	if (was_dropped) {
+		// Keep our snapshot in sync
+		save_config_snapshot();
 	}
-#endif
-
-	return 0;
+	return timeout;
 }
 
 // NOTE: This is essentially the list of invalid characters in FAT32 filenames, plus '.' & ' '
@@ -1269,7 +3575,7 @@ static bool
 	int  ret =
 	    snprintf(images_path, sizeof(images_path), "%s/.kobo-images/%u/%u", KFMON_TARGET_MOUNTPOINT, dir1, dir2);
 	if (ret < 0 || (size_t) ret >= sizeof(images_path)) {
-		LOG(LOG_WARNING, "Couldn't build the image path string!");
+		CLOG(LOG_CAT_THUMBNAILS, LOG_WARNING, "Couldn't build the image path string!");
 
 		// Which means the rest of this is definitely not gonna work ;)
 		return false;
@@ -1303,7 +3609,10 @@ static bool
 			       image_id,
 			       thumbnail->suffix);
 		if (ret < 0 || (size_t) ret >= sizeof(thumbnail_path)) {
-			LOG(LOG_WARNING, "Couldn't build the %s thumbnail path string!", thumbnail->description);
+			CLOG(LOG_CAT_THUMBNAILS,
+			     LOG_WARNING,
+			     "Couldn't build the %s thumbnail path string!",
+			     thumbnail->description);
 
 			// Don't bother checking that, then ;)
 			continue;
@@ -1313,7 +3622,10 @@ static bool
 		if (access(thumbnail_path, F_OK) == 0) {
 			thumbnails_count++;
 		} else {
-			LOG(LOG_INFO, "Thumbnail for %s hasn't been parsed yet!", thumbnail->description);
+			CLOG(LOG_CAT_THUMBNAILS,
+			     LOG_INFO,
+			     "Thumbnail for %s hasn't been parsed yet!",
+			     thumbnail->description);
 		}
 	}
 
@@ -1370,7 +3682,10 @@ static bool
 				   KFMON_TARGET_MOUNTPOINT,
 				   thumbnail.munged_file_path);
 		if (ret < 0 || (size_t) ret >= sizeof(thumbnail_path)) {
-			LOG(LOG_WARNING, "Couldn't build the %s thumbnail path string", thumbnail.variant);
+			CLOG(LOG_CAT_THUMBNAILS,
+			     LOG_WARNING,
+			     "Couldn't build the %s thumbnail path string",
+			     thumbnail.variant);
 
 			// Don't bother checking that, then ;)
 			continue;
@@ -1383,7 +3698,11 @@ static bool
 			// First match wins
 			break;
 		} else {
-			LOG(LOG_INFO, "%s thumbnail (%s) hasn't been parsed yet!", thumbnail.variant, thumbnail_path);
+			CLOG(LOG_CAT_THUMBNAILS,
+			     LOG_INFO,
+			     "%s thumbnail (%s) hasn't been parsed yet!",
+			     thumbnail.variant,
+			     thumbnail_path);
 		}
 	}
 
@@ -1407,6 +3726,14 @@ static bool
 	bool is_processed = false;
 	bool needs_update = false;
 
+	kfStats.db_checks++;
+	struct timespec check_ts;
+	trace_mark(&check_ts);
+	struct timespec sql_ts;
+	trace_mark(&sql_ts);
+	struct timespec lookup_ts;
+	stats_mark(&lookup_ts);
+
 	// NOTE: Open the db in single-thread threading mode (we build w/o threadsafe),
 	//       and without a shared cache: we only do SQL from the main thread.
 	sqlite3* db;
@@ -1503,11 +3830,12 @@ static bool
 				// Warn, and update book_path, so we don't have to do any more slow case-insensitive queries...
 				snprintf(book_path, sizeof(book_path), "%s", sqlite3_column_text(stmt, 0));
 				DBGLOG("SELECT SQL query returned: %s", book_path);
-				LOG(LOG_WARNING,
-				    "Watch config @ index %hhu has a filename field with broken case (%s -> %s)!",
-				    watch_idx,
-				    watchConfig[watch_idx].filename,
-				    book_path + 7);
+				CLOG(LOG_CAT_SQL,
+				     LOG_WARNING,
+				     "Watch config @ index %hhu has a filename field with broken case (%s -> %s)!",
+				     watch_idx,
+				     watchConfig[watch_idx].filename,
+				     book_path + 7);
 			}
 
 			sqlite3_finalize(stmt);
@@ -1515,6 +3843,9 @@ static bool
 	}
 	*/
 
+	trace_span("sql", "sql", &sql_ts, (int8_t) watch_idx, 0);
+	stats_observe(LATENCY_SQL, &lookup_ts);
+
 	// Now that we know the book exists, we also want to check if the thumbnails do,
 	// to avoid getting triggered from the thumbnail creation...
 	// NOTE: Again, this assumes FW >= 2.9.0
@@ -1540,6 +3871,10 @@ static bool
 			// NOTE: I'm not sure we actually have/support Tolinos running FW 4.x,
 			//       so the test could *probably* be simplified to just !tolino...
 			//       c.f., #20
+			struct timespec thumbnails_ts;
+			trace_mark(&thumbnails_ts);
+			struct timespec probe_ts;
+			stats_mark(&probe_ts);
 			if (fwVersion < 50U || !fbinkState.is_tolino) {
 				const unsigned char* image_id = sqlite3_column_text(stmt, 0);
 				size_t               len      = (size_t) sqlite3_column_bytes(stmt, 0);
@@ -1549,6 +3884,8 @@ static bool
 			} else {
 				is_processed = check_fw_5x_thumbnails(book_path, sizeof(book_path));
 			}
+			trace_span("thumbnails", "thumbnails", &thumbnails_ts, (int8_t) watch_idx, 0);
+			stats_observe(LATENCY_THUMBNAILS, &probe_ts);
 		}
 
 		// NOTE: It's now safe to destroy the statement.
@@ -1566,6 +3903,7 @@ static bool
 	//       As such, we leave enabling this option to the user's responsibility.
 	//       KOReader ships with it disabled.
 	//       The idea is to, optionally, update the Title, Author & Comment fields to make them more useful...
+	trace_mark(&sql_ts);
 	if (is_processed && update) {
 		// Check if the DB has already been updated by checking the title...
 		CALL_SQLITE(prepare_v2(
@@ -1606,13 +3944,16 @@ static bool
 
 		rc = sqlite3_step(stmt);
 		if (rc != SQLITE_DONE) {
-			LOG(LOG_WARNING, "UPDATE SQL query failed: %s", sqlite3_errmsg(db));
+			CLOG(LOG_CAT_SQL, LOG_WARNING, "UPDATE SQL query failed: %s", sqlite3_errmsg(db));
 		} else {
-			LOG(LOG_NOTICE, "Successfully updated DB data for the target PNG");
+			CLOG(LOG_CAT_SQL, LOG_NOTICE, "Successfully updated DB data for the target PNG");
 		}
 
 		sqlite3_finalize(stmt);
 	}
+	if (is_processed && update) {
+		trace_span("sql_update", "sql", &sql_ts, (int8_t) watch_idx, 0);
+	}
 
 	// A rather crappy check to wait for pending COMMITs...
 	if (is_processed && wait_for_db) {
@@ -1623,14 +3964,16 @@ static bool
 		const struct timespec zzz   = { 0L, 500000000L };
 		uint8_t               count = 0U;
 		while (access(KOBO_DB_PATH "-journal", F_OK) == 0) {
-			LOG(LOG_INFO,
-			    "Found a SQLite rollback journal, waiting for it to go away (iteration nr. %hhu) . . .",
-			    (uint8_t) count++);
+			CLOG(LOG_CAT_SQL,
+			     LOG_INFO,
+			     "Found a SQLite rollback journal, waiting for it to go away (iteration nr. %hhu) . . .",
+			     (uint8_t) count++);
 			nanosleep(&zzz, NULL);
 			// NOTE: Don't wait more than 10s
 			if (count >= 20U) {
-				LOG(LOG_WARNING,
-				    "Waited for the SQLite rollback journal to go away for far too long, going on anyway.");
+				CLOG(LOG_CAT_SQL,
+				     LOG_WARNING,
+				     "Waited for the SQLite rollback journal to go away for far too long, going on anyway.");
 				break;
 			}
 		}
@@ -1638,6 +3981,7 @@ static bool
 
 	sqlite3_close(db);
 
+	trace_span("is_target_processed", "sql", &check_ts, (int8_t) watch_idx, 0);
 	return is_processed;
 }
 
@@ -1649,6 +3993,7 @@ static void
 	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
 		PT.spawn_pids[i]     = -1;
 		PT.spawn_watchids[i] = -1;
+		WD[i].pgid           = -1;
 	}
 }
 
@@ -1680,6 +4025,100 @@ static void
 	PT.spawn_watchids[i] = -1;
 }
 
+// Records a new spawn in the history ring, overwriting the oldest entry if need be.
+// NOTE: Expects ptlock to be held.
+static void
+    record_spawn(pid_t pid, uint8_t watch_idx, SpawnSource source)
+{
+	SpawnRecord* restrict record = &SH.records[SH.next];
+
+	*record           = (const SpawnRecord) { 0 };
+	record->pid       = pid;
+	record->watch_idx = (int8_t) watch_idx;
+	record->source    = source;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &record->start_ts);
+	str5cpy(record->name, CFG_SZ_MAX, basename(watchConfig[watch_idx].filename), CFG_SZ_MAX, TRUNC);
+
+	SH.next = (uint8_t) ((SH.next + 1U) % HISTORY_MAX);
+	if (SH.count < HISTORY_MAX) {
+		SH.count++;
+	}
+
+	JournalRecord entry = { 0 };
+	entry.type          = JOURNAL_EV_SPAWN;
+	entry.watch_idx     = record->watch_idx;
+	entry.source        = (uint8_t) source;
+	entry.spawn.pid     = pid;
+	journal_append(&entry, record->name);
+}
+
+// Records how a spawn turned out in the history ring.
+// If is_lost, we failed to reap it, and wstatus is meaningless.
+// NOTE: Expects ptlock to be held.
+static void
+    record_exit(pid_t pid, int wstatus, bool is_lost)
+{
+	// Walk the ring backwards, starting from the most recent entry
+	for (uint8_t n = 0U; n < SH.count; n++) {
+		SpawnRecord* restrict record = &SH.records[(SH.next + HISTORY_MAX - 1U - n) % HISTORY_MAX];
+		if (record->pid != pid || record->has_exited) {
+			continue;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC_RAW, &record->end_ts);
+		record->has_exited = true;
+		if (is_lost) {
+			record->was_lost = true;
+			record->status   = -1;
+		} else if (WIFSIGNALED(wstatus)) {
+			record->was_signaled = true;
+			record->status       = WTERMSIG(wstatus);
+		} else {
+			record->status = WEXITSTATUS(wstatus);
+		}
+
+		long long int duration_ms =
+		    ((long long int) record->end_ts.tv_sec * 1000LL + record->end_ts.tv_nsec / 1000000L) -
+		    ((long long int) record->start_ts.tv_sec * 1000LL + record->start_ts.tv_nsec / 1000000L);
+		JournalRecord entry     = { 0 };
+		entry.type              = JOURNAL_EV_EXIT;
+		entry.watch_idx         = record->watch_idx;
+		entry.source            = record->source;
+		entry.flags             = record->was_signaled ? JOURNAL_FL_SIGNALED : (is_lost ? JOURNAL_FL_LOST : 0U);
+		entry.spawn.pid         = pid;
+		entry.spawn.code        = record->status;
+		entry.spawn.duration_ms = (uint32_t) duration_ms;
+		journal_append(&entry, record->name);
+		return;
+	}
+}
+
+// How a spawn turned out, for IPC consumption (history & exit events)
+static const char*
+    exit_state_to_str(const SpawnRecord* record)
+{
+	if (!record->has_exited) {
+		return "running";
+	}
+	if (record->was_lost) {
+		return "lost";
+	}
+	return record->was_signaled ? "killed" : "exited";
+}
+
+static const char*
+    spawn_source_to_str(uint8_t source)
+{
+	switch (source) {
+		case SPAWN_FROM_INOTIFY:
+			return "inotify";
+		case SPAWN_FROM_IPC:
+			return "ipc";
+		default:
+			return "unknown";
+	}
+}
+
 // Initializes the FBInk config
 static void
     init_fbink_config(void)
@@ -1714,22 +4153,18 @@ static void*
 	watch_idx = (uint8_t) PT.spawn_watchids[i];
 	pthread_mutex_unlock(&ptlock);
 
-	// Storage needed for get_current_time_r
-	struct tm local_tm;
-	char      sz_time[22];
-
-	// Remember the current time for the execvp errno/exitcode heuristic...
-	struct timespec then = { 0 };
-	clock_gettime(CLOCK_MONOTONIC_RAW, &then);
+	struct timespec child_ts;
+	trace_mark(&child_ts);
 
-	MTLOG(LOG_INFO,
-	      "[%s] [INFO] [TID: %ld] Waiting to reap process %ld (from watch idx %hhu) . . .",
-	      get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
-	      (long) tid,
-	      (long) cpid,
-	      watch_idx);
+	CLOG(LOG_CAT_SPAWN,
+	     LOG_INFO,
+	     "[TID: %ld] Waiting to reap process %ld (from watch idx %hhu) . . .",
+	     (long) tid,
+	     (long) cpid,
+	     watch_idx);
 	pid_t ret;
-	int   wstatus;
+	int   wstatus = 0;
+	bool  is_lost = false;
 	// Wait for our child process to terminate, retrying on EINTR
 	// NOTE: This is quite likely overkill on Linux (c.f., https://stackoverflow.com/a/59795677)
 	do {
@@ -1738,50 +4173,30 @@ static void*
 	// Recap what happened to it
 	if (ret != cpid) {
 		PFMTLOG(LOG_CRIT, "waitpid: %m");
-		free(ptr);
-		return (void*) NULL;
+		// NOTE: There's nothing left to wait for, but we still have to release the process table slot,
+		//       otherwise that watch could never be launched again,
+		//       and to let everyone waiting on that process know it's gone (c.f., complete_exit_waits).
+		is_lost = true;
 	} else {
 		if (WIFEXITED(wstatus)) {
 			int exitcode = WEXITSTATUS(wstatus);
-			MTLOG(
-			    LOG_NOTICE,
-			    "[%s] [NOTE] [TID: %ld] Reaped process %ld (from watch idx %hhu): It exited with status %d.",
-			    get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
-			    (long) tid,
-			    (long) cpid,
-			    watch_idx,
-			    exitcode);
-			// NOTE: Ugly hack to try to salvage execvp's potential error...
-			//       If the process exited with a non-zero status code,
-			//       within (roughly) a second of being launched,
-			//       assume the exit code is actually inherited from execvp's errno...
-			struct timespec now = { 0 };
-			clock_gettime(CLOCK_MONOTONIC_RAW, &now);
-			// NOTE: We should be okay not using difftime on Linux (We're using a monotonic clock, time_t is int64_t).
-			if (exitcode != 0 && (now.tv_sec - then.tv_sec) <= 1) {
-				char        buf[256];
-				// NOTE: We *know* we'll be using the GNU, glibc >= 2.13 version of strerror_r
-				// NOTE: Even if it's not entirely clear from the manpage, printf's %m *is* thread-safe,
-				//       c.f., stdio-common/vfprintf.c:962 (it's using strerror_r).
-				//       But since we're not checking errno but a custom variable, do it the hard way :)
-				const char* sz_error = strerror_r(exitcode, buf, sizeof(buf));
-				MTLOG(
-				    LOG_CRIT,
-				    "[%s] [CRIT] [TID: %ld] If nothing was visibly launched, and/or especially if status > 1, this *may* actually be an execvp() error: %s.",
-				    get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
-				    (long) tid,
-				    sz_error);
-				FB_PRINTF("[KFMon] PID %ld exited unexpectedly: %d!", (long) cpid, exitcode);
-			}
+			CLOG(LOG_CAT_SPAWN,
+			     LOG_NOTICE,
+			     "[TID: %ld] Reaped process %ld (from watch idx %hhu): It exited with status %d.",
+			     (long) tid,
+			     (long) cpid,
+			     watch_idx,
+			     exitcode);
 		} else if (WIFSIGNALED(wstatus)) {
 			// NOTE: strsignal is not thread safe... Use psignal instead.
-			int  sigcode = WTERMSIG(wstatus);
-			char buf[256];
+			int            sigcode  = WTERMSIG(wstatus);
+			TimeStampCache ts_cache = { 0 };
+			char           buf[256];
 			snprintf(
 			    buf,
 			    sizeof(buf),
 			    "[KFMon] [%s] [WARN] [TID: %ld] Reaped process %ld (from watch idx %hhu): It was killed by signal %d",
-			    get_current_time_r(&local_tm, sz_time, sizeof(sz_time)),
+			    format_timestamp(&ts_cache, time(NULL)),
 			    (long) tid,
 			    (long) cpid,
 			    watch_idx,
@@ -1792,16 +4207,28 @@ static void*
 				//       (the %m token only works for errno)...
 				syslog(LOG_NOTICE, "%s", buf);
 			} else {
+				// NOTE: psignal writes to stderr directly, flush the ring first to keep things in order.
+				log_flush();
 				psignal(sigcode, buf);
 			}
 		}
 	}
 
-	// And now we can safely remove it from the process table
+	// Record the child's lifetime on its own track
+	trace_span("child", "spawn", &child_ts, (int8_t) watch_idx, cpid);
+
+	// And now we can safely remove it from the process table, and remember how it went
 	pthread_mutex_lock(&ptlock);
+	record_exit(cpid, wstatus, is_lost);
 	remove_process_from_table(i);
+	kfStats.reapers_cpu_us += get_thread_cpu_us(CLOCK_THREAD_CPUTIME_ID);
 	pthread_mutex_unlock(&ptlock);
 
+	// Wake the main thread up, so it can publish the exit, and check whether a queued launch can now go through
+	if (eventfd_write(queue_efd, 1U) == -1) {
+		PFMTLOG(LOG_WARNING, "eventfd_write: %m");
+	}
+
 	free(ptr);
 
 	return (void*) NULL;
@@ -1811,9 +4238,24 @@ static void*
 // Initially inspired from popen2() implementations from https://stackoverflow.com/questions/548063
 // As well as the glibc's system() call,
 // With a bit of added tracking to handle reaping without a SIGCHLD handler.
+// Returns -1 if the command couldn't be executed (in which case it has already been reaped).
 static pid_t
-    spawn(char* const* command, uint8_t watch_idx)
+    spawn(char* const* command, uint8_t watch_idx, SpawnSource source)
 {
+	// NOTE: We use the classic close-on-exec pipe trick to find out whether execvp succeeded:
+	//       on success, the write end is closed by the exec, and our read returns 0,
+	//       on failure, the child sends us execvp's errno before exiting.
+	int status_pipe[2];
+	if (pipe2(status_pipe, O_CLOEXEC) == -1) {
+		PFLOG(LOG_ERR, "Aborting: pipe2: %m");
+		FB_PRINT("[KFMon] pipe2 failed ?!");
+		exit(EXIT_FAILURE);
+	}
+
+	struct timespec fork_ts;
+	trace_mark(&fork_ts);
+	struct timespec launch_ts;
+	stats_mark(&launch_ts);
 	pid_t pid = fork();
 
 	if (pid < 0) {
@@ -1826,6 +4268,7 @@ static pid_t
 		// NOTE: We're multithreaded & forking, this means that from this point on until execve(),
 		//       we can only use async-safe functions!
 		//       See pthread_atfork(3) for details.
+		close(status_pipe[0]);
 		// Do the whole stdin/stdout/stderr dance again,
 		// to ensure that child process doesn't inherit our tweaked fds...
 		dup2(origStdin, fileno(stdin));
@@ -1837,16 +4280,68 @@ static pid_t
 		// Restore signals
 		struct sigaction sa = { .sa_handler = SIG_DFL, .sa_flags = SA_RESTART };
 		sigaction(SIGHUP, &sa, NULL);
+		// Lead our own process group, so that the watchdog can take the whole tree down if need be
+		setpgid(0, 0);
 		// NOTE: We used to use execvpe when being launched from udev,
 		//       in order to sanitize all the crap we inherited from udev's env ;).
 		//       Now, we actually rely on the specific env we inherit from rcS/on-animator!
 		execvp(*command, command);
 		// NOTE: This will only ever be reached on error, hence the lack of actual return value check ;).
-		//       Resort to an ugly hack by exiting with execvp()'s errno,
-		//       which we can then try to salvage in the reaper thread.
-		exit(errno);
+		//       Let the parent know why, and get out with the customary "command not found" exit code.
+		// NOTE: xwrite retries on EINTR, and only relies on async-safe calls (write & poll).
+		//       If that fails anyway, there's nothing more we can do about it:
+		//       the parent will simply treat the short read as a successful execvp,
+		//       and the reaper will see the 127.
+		int exec_errno = errno;
+		(void) xwrite(status_pipe[1], &exec_errno, sizeof(exec_errno));
+		_exit(127);
 	} else {
 		// Parent
+		trace_span("fork", "spawn", &fork_ts, (int8_t) watch_idx, 0);
+		// NOTE: Do it on both sides to avoid racing with the child.
+		//       This will fail with EACCES if the child has already gone through execvp, which is fine.
+		setpgid(pid, pid);
+
+		// Wait for the verdict on execvp
+		struct timespec exec_ts;
+		trace_mark(&exec_ts);
+		close(status_pipe[1]);
+		int     exec_errno = 0;
+		ssize_t len        = xread(status_pipe[0], &exec_errno, sizeof(exec_errno));
+		close(status_pipe[0]);
+		trace_span("exec", "spawn", &exec_ts, (int8_t) watch_idx, 0);
+		stats_observe(LATENCY_EXEC, &launch_ts);
+		// NOTE: Only a complete errno means execvp failed (c.f., the child side)
+		if (len == (ssize_t) sizeof(exec_errno)) {
+			kfStats.exec_failures++;
+			// It failed, so the child is already on its way out: reap it right now.
+			CLOG(LOG_CAT_SPAWN,
+			     LOG_CRIT,
+			     "Failed to execute %s (@ watch idx %hhu): %s",
+			     watchConfig[watch_idx].action,
+			     watch_idx,
+			     strerror(exec_errno));
+			FB_PRINTF("[KFMon] Failed to launch %s: %s!",
+				  basename(watchConfig[watch_idx].action),
+				  strerror(exec_errno));
+
+			int wstatus = 0;
+			while (waitpid(pid, &wstatus, 0) == -1 && errno == EINTR) {
+				;
+			}
+			pthread_mutex_lock(&ptlock);
+			record_spawn(pid, watch_idx, source);
+			record_exit(pid, wstatus, false);
+			pthread_mutex_unlock(&ptlock);
+			publish_exit_events();
+
+			return -1;
+		}
+
+		kfStats.spawns++;
+		struct timespec spawn_ts;
+		trace_mark(&spawn_ts);
+
 		// Keep track of the process
 		int8_t i;
 		pthread_mutex_lock(&ptlock);
@@ -1859,38 +4354,48 @@ static pid_t
 			//       One of the benefits of the double-fork we do to daemonize is that, on our death,
 			//       our children will get reparented to init, which, by design,
 			//       will handle the reaping automatically.
-			LOG(LOG_ERR,
-			    "Failed to find an available entry in our process table for pid %ld, aborting!",
-			    (long) pid);
+			CLOG(LOG_CAT_SPAWN,
+			     LOG_ERR,
+			     "Failed to find an available entry in our process table for pid %ld, aborting!",
+			     (long) pid);
 			FB_PRINT("[KFMon] Can't spawn any more processes!");
 			exit(EXIT_FAILURE);
 		} else {
 			pthread_mutex_lock(&ptlock);
 			add_process_to_table((uint8_t) i, pid, watch_idx);
+			record_spawn(pid, watch_idx, source);
 			pthread_mutex_unlock(&ptlock);
 
+			watchdog_track((uint8_t) i, pid, watch_idx);
+
 			DBGLOG("Assigned pid %ld (from watch idx %hhu) to process table entry idx %hhd",
 			       (long) pid,
 			       watch_idx,
 			       i);
 			// NOTE: We can't do that from the child proper, because it's not async-safe,
 			//       so do it from here.
-			LOG(LOG_NOTICE,
-			    "Spawned process %ld (%s -> %s @ watch idx %hhu) . . .",
-			    (long) pid,
-			    watchConfig[watch_idx].filename,
-			    watchConfig[watch_idx].action,
-			    watch_idx);
+			CLOG(LOG_CAT_SPAWN,
+			     LOG_NOTICE,
+			     "Spawned process %ld (%s -> %s @ watch idx %hhu) . . .",
+			     (long) pid,
+			     watchConfig[watch_idx].filename,
+			     watchConfig[watch_idx].action,
+			     watch_idx);
 			if (daemonConfig.with_notifications) {
 				FB_PRINTF("[KFMon] Launched %s :)", basename(watchConfig[watch_idx].action));
 			}
+			publish_event("EVENT:spawn:%hhu:%s:%ld\n",
+				      watch_idx,
+				      basename(watchConfig[watch_idx].filename),
+				      (long) pid);
+			update_status_page();
 			// NOTE: We achieve reaping in a non-blocking way by doing the reaping from a dedicated thread
 			//       for every spawn...
 			//       See #2 for an history of the previous failed attempts...
 			pthread_t rthread;
 			uint8_t*  arg = malloc(sizeof(*arg));
 			if (arg == NULL) {
-				LOG(LOG_ERR, "Couldn't allocate memory for thread arg, aborting!");
+				CLOG(LOG_CAT_SPAWN, LOG_ERR, "Couldn't allocate memory for thread arg, aborting!");
 				FB_PRINT("[KFMon] OOM ?!");
 				exit(EXIT_FAILURE);
 			}
@@ -1942,6 +4447,7 @@ static pid_t
 				exit(EXIT_FAILURE);
 			}
 		}
+		trace_span("spawn", "spawn", &spawn_ts, (int8_t) watch_idx, 0);
 	}
 
 	return pid;
@@ -2019,6 +4525,401 @@ static pid_t
 	return -1;
 }
 
+// Queue a launch request for a watch, to be retried whenever a spawn exits, for at most ttl seconds.
+// Returns 0 if it was queued, 1 if it was already queued (in which case its deadline is extended), -ENOSPC if the queue is full.
+static int
+    queue_launch(uint8_t watch_idx, SpawnSource source, unsigned short int ttl)
+{
+	struct timespec deadline = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &deadline);
+	deadline.tv_sec += ttl;
+
+	// Dedup: a watch can only be queued once
+	for (uint8_t i = 0U; i < LQ.count; i++) {
+		if (LQ.entries[i].watch_idx == watch_idx) {
+			if (deadline.tv_sec > LQ.entries[i].deadline.tv_sec) {
+				LQ.entries[i].deadline = deadline;
+			}
+			return 1;
+		}
+	}
+
+	if (LQ.count >= QUEUE_MAX) {
+		kfStats.dropped_triggers++;
+		return -ENOSPC;
+	}
+
+	// First one in, the first retry is a QUEUE_RETRY_MS away
+	if (LQ.count == 0U) {
+		schedule_queue_retry();
+	}
+
+	kfStats.queued_triggers++;
+	QueuedLaunch* restrict entry = &LQ.entries[LQ.count++];
+	entry->deadline              = deadline;
+	entry->watch_idx             = watch_idx;
+	entry->source                = source;
+	str5cpy(entry->name, CFG_SZ_MAX, basename(watchConfig[watch_idx].filename), CFG_SZ_MAX, TRUNC);
+
+	return 0;
+}
+
+// Push back the next retry of the launch queue to QUEUE_RETRY_MS from now
+static void
+    schedule_queue_retry(void)
+{
+	clock_gettime(CLOCK_MONOTONIC_RAW, &LQ.retry_ts);
+	LQ.retry_ts.tv_sec  += QUEUE_RETRY_MS / 1000;
+	LQ.retry_ts.tv_nsec += (QUEUE_RETRY_MS % 1000) * 1000000L;
+	if (LQ.retry_ts.tv_nsec >= 1000000000L) {
+		LQ.retry_ts.tv_sec++;
+		LQ.retry_ts.tv_nsec -= 1000000000L;
+	}
+}
+
+// Remove an entry from the launch queue, preserving the order of the others.
+static void
+    remove_queued_launch(uint8_t i)
+{
+	memmove(&LQ.entries[i], &LQ.entries[i + 1U], (size_t) (LQ.count - i - 1U) * sizeof(*LQ.entries));
+	LQ.count--;
+}
+
+// Give up on a queued launch request
+static void
+    drop_queued_launch(uint8_t i)
+{
+	kfStats.dropped_triggers++;
+	remove_queued_launch(i);
+}
+
+// Walk the launch queue, in order, and spawn whatever can now be spawned, dropping expired requests along the way.
+static void
+    dispatch_queued_launches(void)
+{
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	uint8_t i = 0U;
+	while (i < LQ.count) {
+		const QueuedLaunch* restrict entry     = &LQ.entries[i];
+		uint8_t                      watch_idx = entry->watch_idx;
+
+		// Make sure the watch is still there, and is still the same one
+		if (!watchConfig[watch_idx].is_active ||
+		    strcmp(basename(watchConfig[watch_idx].filename), entry->name) != 0) {
+			CLOG(LOG_CAT_EVENTS,
+			     LOG_NOTICE,
+			     "Dropping queued launch of '%s', as its watch is gone",
+			     entry->name);
+			drop_queued_launch(i);
+			continue;
+		}
+
+		if (now.tv_sec > entry->deadline.tv_sec ||
+		    (now.tv_sec == entry->deadline.tv_sec && now.tv_nsec >= entry->deadline.tv_nsec)) {
+			CLOG(LOG_CAT_EVENTS,
+			     LOG_NOTICE,
+			     "Dropping queued launch of '%s', as it has expired",
+			     entry->name);
+			if (daemonConfig.with_notifications) {
+				FB_PRINTF("[KFMon] Gave up on %s: timed out!", basename(watchConfig[watch_idx].action));
+			}
+			drop_queued_launch(i);
+			continue;
+		}
+
+		// See handle_events for the logic behind spawn blocking & co.
+		bool is_watch_spawned;
+		bool is_blocker_spawned;
+		pthread_mutex_lock(&ptlock);
+		is_watch_spawned   = is_watch_already_spawned(watch_idx);
+		is_blocker_spawned = is_blocker_running();
+		pthread_mutex_unlock(&ptlock);
+		if (is_watch_spawned || is_blocker_spawned || are_spawns_blocked()) {
+			// Still blocked, keep it around
+			i++;
+			continue;
+		}
+
+		// Inotify triggers were queued before we got to run the SQL checks, so do that now.
+		if (entry->source == SPAWN_FROM_INOTIFY && !is_target_processed(watch_idx, true)) {
+			CLOG(LOG_CAT_EVENTS,
+			     LOG_NOTICE,
+			     "Dropping queued launch of '%s', as it might not have been fully processed by Nickel yet",
+			     entry->name);
+			drop_queued_launch(i);
+			continue;
+		}
+
+		CLOG(LOG_CAT_EVENTS,
+		     LOG_INFO,
+		     "Preparing to spawn %s for watch idx %hhu (from the launch queue) . . .",
+		     watchConfig[watch_idx].action,
+		     watch_idx);
+		SpawnSource source = entry->source;
+		remove_queued_launch(i);
+		// We're using execvp()...
+		char* const cmd[] = { watchConfig[watch_idx].action, NULL };
+		spawn(cmd, watch_idx, source);
+	}
+}
+
+// Start keeping an eye on a fresh spawn, if its watch has a watchdog policy.
+static void
+    watchdog_track(uint8_t i, pid_t pid, uint8_t watch_idx)
+{
+	// If that slot was still waiting to send the final SIGKILL to a previous spawn's group, do it now.
+	if (WD[i].pgid != -1 && WD[i].is_terminating) {
+		watchdog_finish(&WD[i]);
+	}
+	WD[i] = (const WatchdogEntry) { .pgid = -1 };
+
+	if (watchConfig[watch_idx].max_runtime == 0U && watchConfig[watch_idx].max_idle == 0U) {
+		return;
+	}
+
+	// The spawn is its own process group leader (c.f., spawn)
+	WD[i].pgid      = pid;
+	WD[i].watch_idx = watch_idx;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &WD[i].start_ts);
+	// NOTE: It has barely started, so its cpu_ticks baseline is 0, which saves us a trip through /proc.
+	WD[i].active_ts = WD[i].start_ts;
+
+	watchdog_set_timer(true);
+}
+
+// Arm (to tick every second) or disarm the watchdog timer
+static void
+    watchdog_set_timer(bool armed)
+{
+	if (armed == watchdog_armed) {
+		return;
+	}
+
+	struct itimerspec its = { 0 };
+	if (armed) {
+		its.it_interval.tv_sec = 1;
+		its.it_value.tv_sec    = 1;
+	}
+	if (timerfd_settime(watchdog_tfd, 0, &its, NULL) == -1) {
+		PFLOG(LOG_WARNING, "timerfd_settime: %m");
+		return;
+	}
+	watchdog_armed = armed;
+}
+
+// Look up the members of a few process groups in a single pass through /proc.
+static void
+    scan_pgrps(PgrpInfo* pgrps, uint8_t count)
+{
+	for (uint8_t n = 0U; n < count; n++) {
+		pgrps[n] = (const PgrpInfo) { .pgid = pgrps[n].pgid };
+	}
+
+	DIR* dir = opendir("/proc");
+	if (!dir) {
+		PFLOG(LOG_WARNING, "opendir: %m");
+		return;
+	}
+
+	const struct dirent* de;
+	while ((de = readdir(dir)) != NULL) {
+		// Only look at pids
+		if (de->d_name[0] < '0' || de->d_name[0] > '9') {
+			continue;
+		}
+
+		char stat_path[PATH_MAX];
+		snprintf(stat_path, sizeof(stat_path), "/proc/%s/stat", de->d_name);
+		FILE* f = fopen(stat_path, "re");
+		if (!f) {
+			// It may have exited in the meantime
+			continue;
+		}
+		char  line[512];
+		char* comm_end = NULL;
+		if (fgets(line, sizeof(line), f)) {
+			// Skip over comm, which may contain spaces and parentheses
+			comm_end = strrchr(line, ')');
+		}
+		fclose(f);
+		if (!comm_end) {
+			continue;
+		}
+
+		// c.f., proc(5): we want pgrp (5), utime (14), stime (15), cutime (16), cstime (17) & starttime (22)
+		int                pgrp;
+		unsigned long int  utime;
+		unsigned long int  stime;
+		long int           cutime;
+		long int           cstime;
+		unsigned long long starttime;
+		if (sscanf(comm_end + 2,
+			   "%*c %*d %d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu %ld %ld %*d %*d %*d %*d %llu",
+			   &pgrp,
+			   &utime,
+			   &stime,
+			   &cutime,
+			   &cstime,
+			   &starttime) != 6) {
+			continue;
+		}
+		for (uint8_t n = 0U; n < count; n++) {
+			PgrpInfo* info = &pgrps[n];
+			if (pgrp != info->pgid) {
+				continue;
+			}
+
+			info->cpu_ticks += utime + stime + (unsigned long int) cutime + (unsigned long int) cstime;
+			if (info->members == 0U || starttime < info->oldest_start) {
+				info->oldest_start = starttime;
+			}
+			if (info->members == 0U || starttime > info->newest_start) {
+				info->newest_start = starttime;
+			}
+			info->members++;
+			break;
+		}
+	}
+	closedir(dir);
+}
+
+// Send the final SIGKILL to a process group that was sent a SIGTERM WATCHDOG_GRACE seconds ago.
+// NOTE: Its leader may very well have been reaped by now, so if the whole group went away with it,
+//       its pgid is up for grabs. It's only still ours if one of its members was already around
+//       when we sent the SIGTERM.
+static void
+    watchdog_finish(const WatchdogEntry* entry)
+{
+	PgrpInfo info = { .pgid = entry->pgid };
+	scan_pgrps(&info, 1U);
+	if (info.members == 0U || info.oldest_start > entry->term_start) {
+		CLOG(LOG_CAT_SPAWN,
+		     LOG_INFO,
+		     "Process group %ld (from watch idx %hhu) is gone, no need for a SIGKILL",
+		     (long) entry->pgid,
+		     entry->watch_idx);
+		return;
+	}
+
+	if (kill(-entry->pgid, SIGKILL) == 0) {
+		CLOG(LOG_CAT_SPAWN,
+		     LOG_WARNING,
+		     "Process group %ld (from watch idx %hhu) survived a SIGTERM, sent it a SIGKILL",
+		     (long) entry->pgid,
+		     entry->watch_idx);
+	}
+}
+
+// Check every watched spawn against its watch's policies, and escalate as needed (called on each watchdog_tfd tick).
+static void
+    handle_watchdog(void)
+{
+	// Drain the timer
+	uint64_t expirations;
+	if (read(watchdog_tfd, &expirations, sizeof(expirations)) == -1) {    // Flawfinder: ignore
+		if (errno != EAGAIN) {
+			PFLOG(LOG_WARNING, "read: %m");
+		}
+	}
+
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+	// Forget about the spawns that exited on their own, and figure out which process groups we need to look up
+	PgrpInfo pgrps[WATCH_MAX]    = { 0 };
+	int8_t   pgrp_idx[WATCH_MAX] = { [0 ... WATCH_MAX - 1] = -1 };
+	uint8_t  pgrp_count          = 0U;
+	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
+		const WatchdogEntry* entry = &WD[i];
+		if (entry->pgid == -1 || entry->is_terminating) {
+			continue;
+		}
+
+		bool is_alive;
+		pthread_mutex_lock(&ptlock);
+		is_alive = (PT.spawn_pids[i] == entry->pgid);
+		pthread_mutex_unlock(&ptlock);
+		if (!is_alive) {
+			WD[i].pgid = -1;
+			continue;
+		}
+
+		// NOTE: Only max_idle requires poking at /proc, so only do that when there's such a spawn running.
+		if (watchConfig[entry->watch_idx].max_idle > 0U) {
+			pgrp_idx[i]              = (int8_t) pgrp_count;
+			pgrps[pgrp_count++].pgid = entry->pgid;
+		}
+	}
+	if (pgrp_count > 0U) {
+		scan_pgrps(pgrps, pgrp_count);
+	}
+
+	bool is_watching = false;
+	for (uint8_t i = 0U; i < WATCH_MAX; i++) {
+		WatchdogEntry* restrict entry = &WD[i];
+		if (entry->pgid == -1) {
+			continue;
+		}
+		uint8_t watch_idx = entry->watch_idx;
+
+		// Already sent a SIGTERM? Finish the job once the grace period has elapsed.
+		// NOTE: We keep doing this even if the group leader has already been reaped, because the rest of the group
+		//       might very well have survived the SIGTERM (c.f., watchdog_finish).
+		if (entry->is_terminating) {
+			if (now.tv_sec - entry->term_ts.tv_sec >= WATCHDOG_GRACE) {
+				watchdog_finish(entry);
+				entry->pgid = -1;
+			} else {
+				is_watching = true;
+			}
+			continue;
+		}
+
+		const char* reason = NULL;
+		if (watchConfig[watch_idx].max_runtime > 0U &&
+		    now.tv_sec - entry->start_ts.tv_sec >= watchConfig[watch_idx].max_runtime) {
+			reason = "ran for too long";
+		} else if (pgrp_idx[i] != -1) {
+			unsigned long long ticks = pgrps[pgrp_idx[i]].cpu_ticks;
+			if (ticks != entry->cpu_ticks) {
+				entry->cpu_ticks = ticks;
+				entry->active_ts = now;
+			} else if (now.tv_sec - entry->active_ts.tv_sec >= watchConfig[watch_idx].max_idle) {
+				reason = "was idle for too long";
+			}
+		}
+
+		if (reason) {
+			CLOG(LOG_CAT_SPAWN,
+			     LOG_WARNING,
+			     "Process %ld (%s @ watch idx %hhu) %s, sending a SIGTERM to its process group",
+			     (long) entry->pgid,
+			     watchConfig[watch_idx].action,
+			     watch_idx,
+			     reason);
+			FB_PRINTF("[KFMon] Killing %s: %s!", basename(watchConfig[watch_idx].action), reason);
+			// Remember who's in there right now, so that watchdog_finish can tell if that pgid is still ours
+			PgrpInfo info = { .pgid = entry->pgid };
+			scan_pgrps(&info, 1U);
+			entry->term_start = info.newest_start;
+			if (kill(-entry->pgid, SIGTERM) == -1) {
+				PFLOG(LOG_WARNING, "kill: %m");
+			}
+			kfStats.watchdog_kills++;
+			entry->is_terminating = true;
+			entry->term_ts        = now;
+		}
+		is_watching = true;
+	}
+
+	// Nothing left to watch, we can stop ticking
+	if (!is_watching) {
+		watchdog_set_timer(false);
+	}
+}
+
 // Read all available inotify events from the file descriptor 'fd' (caller breaks on true).
 static bool
     handle_events(int fd)
@@ -2038,11 +4939,7 @@ static bool
 	// NOTE: This was moved from inside the following loop to here, just outside of it, in order to limit locking,
 	//       but it will in fact change nothing if events aren't actually batched,
 	//       which appears to be the case in most of our use-cases...
-	pthread_mutex_lock(&ptlock);
-	if (unlikely(fbink_reinit(FBFD_AUTO, &fbinkConfig) < 0)) {
-		PFLOG(LOG_WARNING, "fbink_reinit: failure");
-	}
-	pthread_mutex_unlock(&ptlock);
+	fb_reinit();
 
 	// Some systems cannot read integer variables if they are not properly aligned.
 	// On other systems, incorrect alignment may decrease performance.
@@ -2056,6 +4953,8 @@ static bool
 	// Loop while events can be read from inotify file descriptor.
 	for (;;) {
 		// Read some events.
+		struct timespec read_ts;
+		trace_mark(&read_ts);
 		ssize_t len = read(fd, buf, sizeof(buf));    // Flawfinder: ignore
 		if (len == -1 && errno != EAGAIN) {
 			if (errno == EINTR) {
@@ -2072,6 +4971,9 @@ static bool
 		if (len <= 0) {
 			break;
 		}
+		trace_span("inotify_read", "events", &read_ts, -1, 0);
+		struct timespec batch_ts;
+		stats_mark(&batch_ts);
 
 		// Loop over all events in the buffer
 		for (char* ptr = buf; ptr < buf + len; ptr += sizeof(*event) + event->len) {
@@ -2081,7 +4983,29 @@ static bool
 			event = (const struct inotify_event*) ptr;
 #pragma GCC diagnostic pop
 
+			// Changes to our config directory are applied on the spot
+			if (configDirWd != -1 && event->wd == configDirWd) {
+				if (event->mask & IN_UNMOUNT) {
+					was_unmounted = true;
+				}
+				if (event->mask & IN_IGNORED) {
+					// It's gone (most likely because onboard was unmounted), start over.
+					CLOG(LOG_CAT_EVENTS,
+					     LOG_NOTICE,
+					     "Tripped IN_IGNORED for config directory '%s'",
+					     KFMON_CONFIGPATH);
+					kfStats.inotify_ignored++;
+					configDirWd  = -1;
+					destroyed_wd = true;
+				} else {
+					handle_config_event(fd, event);
+				}
+				continue;
+			}
+
 			// Identify which of our target file we've caught an event for...
+			struct timespec match_ts;
+			trace_mark(&match_ts);
 			uint8_t watch_idx       = 0U;
 			bool    found_watch_idx = false;
 			for (watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
@@ -2095,19 +5019,30 @@ static bool
 					break;
 				}
 			}
+			if (!found_watch_idx && (event->mask & IN_IGNORED)) {
+				// Tail end of an inotify watch we removed ourselves
+				// (c.f., handle_config_event & drop_gone_configs)
+				continue;
+			}
 			if (!found_watch_idx) {
 				// NOTE: Err, that should (hopefully) never happen!
-				LOG(LOG_CRIT,
-				    "!! Failed to match the current inotify event to any of our watched file! !!");
+				CLOG(LOG_CAT_EVENTS,
+				     LOG_CRIT,
+				     "!! Failed to match the current inotify event to any of our watched file! !!");
 				// NOTE: First, point to the final slot, instead of OOB. This'll at least avoid UB.
 				//       We *probably* ought to fail harder here, though,
 				//       but I *do* want to drain the event...
 				watch_idx = WATCH_MAX - 1;
 			}
+			trace_span("watch_match", "events", &match_ts, (int8_t) watch_idx, 0);
 
 			// Print event type
 			if (event->mask & IN_OPEN) {
-				LOG(LOG_NOTICE, "Tripped IN_OPEN for %s", watchConfig[watch_idx].filename);
+				CLOG(LOG_CAT_EVENTS,
+				     LOG_NOTICE,
+				     "Tripped IN_OPEN for %s",
+				     watchConfig[watch_idx].filename);
+				kfStats.inotify_open++;
 				// Clunky detection of potential Nickel processing...
 				bool is_watch_spawned;
 				bool is_blocker_spawned;
@@ -2121,18 +5056,30 @@ static bool
 					// Only check if we're ready to spawn something...
 					if (!is_target_processed(watch_idx, false)) {
 						// It's not processed on OPEN, flag as pending...
+						if (!watchConfig[watch_idx].pending_processing) {
+							publish_watch_event("processing-pending", watch_idx);
+						}
 						watchConfig[watch_idx].pending_processing = true;
-						LOG(LOG_INFO,
-						    "Flagged target icon '%s' as pending processing ...",
-						    watchConfig[watch_idx].filename);
+						CLOG(LOG_CAT_EVENTS,
+						     LOG_INFO,
+						     "Flagged target icon '%s' as pending processing ...",
+						     watchConfig[watch_idx].filename);
 					} else {
 						// It's already processed, we're good!
+						if (watchConfig[watch_idx].pending_processing) {
+							publish_watch_event("processing-done", watch_idx);
+						}
 						watchConfig[watch_idx].pending_processing = false;
 					}
 				}
+				stats_observe(LATENCY_DECISION, &batch_ts);
 			}
 			if (event->mask & IN_CLOSE) {
-				LOG(LOG_NOTICE, "Tripped IN_CLOSE for %s", watchConfig[watch_idx].filename);
+				CLOG(LOG_CAT_EVENTS,
+				     LOG_NOTICE,
+				     "Tripped IN_CLOSE for %s",
+				     watchConfig[watch_idx].filename);
+				kfStats.inotify_close++;
 				// NOTE: Make sure we won't run a specific command multiple times
 				//       while an earlier instance of it is still running...
 				//       This is mostly of interest for KOReader/Plato:
@@ -2150,6 +5097,9 @@ static bool
 				if (!is_watch_spawned && !is_blocker_spawned && !is_spawn_blocked) {
 					// Check that our target file has already fully been processed by Nickel
 					// before launching anything...
+					if (watchConfig[watch_idx].pending_processing) {
+						kfStats.db_checks_skipped++;
+					}
 					bool should_spawn = !watchConfig[watch_idx].pending_processing &&
 							    is_target_processed(watch_idx, true);
 					// NOTE: In case the target file has been processed during this power cycle,
@@ -2162,39 +5112,46 @@ static bool
 						struct timespec now = { 0 };
 						clock_gettime(CLOCK_MONOTONIC_RAW, &now);
 						if (now.tv_sec - watchConfig[watch_idx].processing_ts <= 10) {
-							LOG(LOG_NOTICE,
-							    "Target icon '%s' has only *just* finished processing, assuming this is a spurious post-processing event!",
-							    watchConfig[watch_idx].filename);
+							CLOG(LOG_CAT_EVENTS,
+							     LOG_NOTICE,
+							     "Target icon '%s' has only *just* finished processing, assuming this is a spurious post-processing event!",
+							     watchConfig[watch_idx].filename);
 							should_spawn = false;
 						} else {
 							// Now that everything appears sane, clear the processing timestamp,
 							// to avoid going through this branch for the rest of this power cycle ;).
-							LOG(LOG_NOTICE,
-							    "Target icon '%s' should be properly processed by now :)",
-							    watchConfig[watch_idx].filename);
+							CLOG(LOG_CAT_EVENTS,
+							     LOG_NOTICE,
+							     "Target icon '%s' should be properly processed by now :)",
+							     watchConfig[watch_idx].filename);
 							watchConfig[watch_idx].processing_ts = 0;
 						}
 					}
+					stats_observe(LATENCY_DECISION, &batch_ts);
 
 					if (should_spawn) {
-						LOG(LOG_INFO,
-						    "Preparing to spawn %s for watch idx %hhu . . .",
-						    watchConfig[watch_idx].action,
-						    watch_idx);
+						CLOG(LOG_CAT_EVENTS,
+						     LOG_INFO,
+						     "Preparing to spawn %s for watch idx %hhu . . .",
+						     watchConfig[watch_idx].action,
+						     watch_idx);
 						if (watchConfig[watch_idx].block_spawns) {
-							LOG(LOG_NOTICE,
-							    "%s is flagged as a spawn blocker, it will prevent *any* event from triggering a spawn while it is still running!",
-							    watchConfig[watch_idx].action);
+							CLOG(LOG_CAT_EVENTS,
+							     LOG_NOTICE,
+							     "%s is flagged as a spawn blocker, it will prevent *any* event from triggering a spawn while it is still running!",
+							     watchConfig[watch_idx].action);
 						}
 						// We're using execvp()...
 						char* const cmd[] = { watchConfig[watch_idx].action, NULL };
-						spawn(cmd, watch_idx);
+						spawn(cmd, watch_idx, SPAWN_FROM_INOTIFY);
 					} else {
-						LOG(LOG_NOTICE,
-						    "Target icon '%s' might not have been fully processed by Nickel yet, don't launch anything.",
-						    watchConfig[watch_idx].filename);
+						CLOG(LOG_CAT_EVENTS,
+						     LOG_NOTICE,
+						     "Target icon '%s' might not have been fully processed by Nickel yet, don't launch anything.",
+						     watchConfig[watch_idx].filename);
 						FB_PRINTF("[KFMon] Not spawning %s: still processing!",
 							  basename(watchConfig[watch_idx].action));
+						publish_blocked_event(watch_idx, "processing");
 						// NOTE: That, or we hit a SQLITE_BUSY timeout on OPEN,
 						//       which tripped our 'pending processing' check.
 						// NOTE: The first time we encounter a not-yet processed file on close,
@@ -2209,35 +5166,60 @@ static bool
 						}
 					}
 				} else {
+					stats_observe(LATENCY_DECISION, &batch_ts);
 					if (is_watch_spawned) {
 						pid_t spid;
 						pthread_mutex_lock(&ptlock);
 						spid = get_spawn_pid_for_watch(watch_idx);
 						pthread_mutex_unlock(&ptlock);
 
-						LOG(LOG_INFO,
-						    "As watch idx %hhu (%s) still has a spawned process (%ld -> %s) running, we won't be spawning another instance of it!",
-						    watch_idx,
-						    watchConfig[watch_idx].filename,
-						    (long) spid,
-						    watchConfig[watch_idx].action);
+						CLOG(LOG_CAT_EVENTS,
+						     LOG_INFO,
+						     "As watch idx %hhu (%s) still has a spawned process (%ld -> %s) running, we won't be spawning another instance of it!",
+						     watch_idx,
+						     watchConfig[watch_idx].filename,
+						     (long) spid,
+						     watchConfig[watch_idx].action);
 						FB_PRINTF("[KFMon] Not spawning %s: still running!",
 							  basename(watchConfig[watch_idx].action));
+						publish_blocked_event(watch_idx, "running");
 					} else if (is_blocker_spawned) {
-						LOG(LOG_INFO,
-						    "As a spawn blocker process is currently running, we won't be spawning anything else to prevent unwanted behavior!");
+						CLOG(LOG_CAT_EVENTS,
+						     LOG_INFO,
+						     "As a spawn blocker process is currently running, we won't be spawning anything else to prevent unwanted behavior!");
 						FB_PRINTF("[KFMon] Not spawning %s: blocked!",
 							  basename(watchConfig[watch_idx].action));
+						publish_blocked_event(watch_idx, "blocker");
 					} else if (is_spawn_blocked) {
-						LOG(LOG_INFO,
-						    "As the global spawn inhibiter flag is present, we won't be spawning anything!");
-						FB_PRINTF("[KFMon] Not spawning %s: inhibited!",
-							  basename(watchConfig[watch_idx].action));
+						// NOTE: This is the only case we honor queue_ttl for,
+						//       as the other two are *designed* to swallow spurious events
+						//       (e.g., from a blocker's own file manager).
+						if (daemonConfig.queue_ttl > 0U &&
+						    queue_launch(watch_idx, SPAWN_FROM_INOTIFY, daemonConfig.queue_ttl) >= 0) {
+							CLOG(LOG_CAT_EVENTS,
+							     LOG_INFO,
+							     "As the global spawn inhibiter flag is present, queued %s for up to %hus",
+							     watchConfig[watch_idx].action,
+							     daemonConfig.queue_ttl);
+							FB_PRINTF("[KFMon] Queued %s: inhibited!",
+								  basename(watchConfig[watch_idx].action));
+						} else {
+							CLOG(LOG_CAT_EVENTS,
+							     LOG_INFO,
+							     "As the global spawn inhibiter flag is present, we won't be spawning anything!");
+							FB_PRINTF("[KFMon] Not spawning %s: inhibited!",
+								  basename(watchConfig[watch_idx].action));
+						}
+						publish_blocked_event(watch_idx, "inhibited");
 					}
 				}
 			}
 			if (event->mask & IN_UNMOUNT) {
-				LOG(LOG_NOTICE, "Tripped IN_UNMOUNT for %s", watchConfig[watch_idx].filename);
+				CLOG(LOG_CAT_EVENTS,
+				     LOG_NOTICE,
+				     "Tripped IN_UNMOUNT for %s",
+				     watchConfig[watch_idx].filename);
+				kfStats.inotify_unmount++;
 				// Remember that we encountered an unmount,
 				// so we don't try to manually remove watches that are already gone...
 				was_unmounted = true;
@@ -2251,23 +5233,34 @@ static bool
 			//       on all our other watches don't seem to error out...
 			//       In the end, we behave properly, but it's still strange enough to document ;).
 			if (event->mask & IN_IGNORED) {
-				LOG(LOG_NOTICE, "Tripped IN_IGNORED for %s", watchConfig[watch_idx].filename);
+				CLOG(LOG_CAT_EVENTS,
+				     LOG_NOTICE,
+				     "Tripped IN_IGNORED for %s",
+				     watchConfig[watch_idx].filename);
+				kfStats.inotify_ignored++;
 				// Remember that the watch was automatically destroyed so we can break from the loop...
 				destroyed_wd                            = true;
 				watchConfig[watch_idx].wd_was_destroyed = true;
 			}
 			if (event->mask & IN_Q_OVERFLOW) {
+				kfStats.inotify_overflow++;
 				if (event->len) {
-					LOG(LOG_WARNING, "Huh oh... Tripped IN_Q_OVERFLOW for %s", event->name);
+					CLOG(LOG_CAT_EVENTS,
+					     LOG_WARNING,
+					     "Huh oh... Tripped IN_Q_OVERFLOW for %s",
+					     event->name);
 				} else {
-					LOG(LOG_WARNING, "Huh oh... Tripped IN_Q_OVERFLOW for... something?");
+					CLOG(LOG_CAT_EVENTS,
+					     LOG_WARNING,
+					     "Huh oh... Tripped IN_Q_OVERFLOW for... something?");
 				}
 				// Try to remove the inotify watch we matched
 				// (... hoping matching actually was successful), and break the loop.
-				LOG(LOG_INFO,
-				    "Trying to remove inotify watch for '%s' @ index %hhu.",
-				    watchConfig[watch_idx].filename,
-				    watch_idx);
+				CLOG(LOG_CAT_EVENTS,
+				     LOG_INFO,
+				     "Trying to remove inotify watch for '%s' @ index %hhu.",
+				     watchConfig[watch_idx].filename,
+				     watch_idx);
 				if (inotify_rm_watch(fd, watchConfig[watch_idx].inotify_wd) == -1) {
 					// That's too bad, but may not be fatal, so warn only...
 					PFLOG(LOG_WARNING, "inotify_rm_watch: %m");
@@ -2282,7 +5275,9 @@ static bool
 
 		// If we caught an unmount, explain why we don't explicitly have to tear down our watches
 		if (was_unmounted) {
-			LOG(LOG_INFO, "Unmount detected, nothing to do, all watches will naturally get destroyed.");
+			CLOG(LOG_CAT_EVENTS,
+			     LOG_INFO,
+			     "Unmount detected, nothing to do, all watches will naturally get destroyed.");
 		}
 		// If we caught an event indicating that a watch was automatically destroyed, break the loop.
 		if (destroyed_wd) {
@@ -2303,16 +5298,18 @@ static bool
 						// Check if that watch index is active to begin with,
 						// as we might have just skipped it if its target file was missing...
 						if (watchConfig[watch_idx].inotify_wd == -1) {
-							LOG(LOG_INFO,
-							    "Inotify watch for '%s' @ index %hhu is already inactive!",
-							    watchConfig[watch_idx].filename,
-							    watch_idx);
+							CLOG(LOG_CAT_EVENTS,
+							     LOG_INFO,
+							     "Inotify watch for '%s' @ index %hhu is already inactive!",
+							     watchConfig[watch_idx].filename,
+							     watch_idx);
 						} else {
 							// Log what we're doing...
-							LOG(LOG_INFO,
-							    "Trying to remove inotify watch for '%s' @ index %hhu.",
-							    watchConfig[watch_idx].filename,
-							    watch_idx);
+							CLOG(LOG_CAT_EVENTS,
+							     LOG_INFO,
+							     "Trying to remove inotify watch for '%s' @ index %hhu.",
+							     watchConfig[watch_idx].filename,
+							     watch_idx);
 							if (inotify_rm_watch(fd, watchConfig[watch_idx].inotify_wd) ==
 							    -1) {
 								// That's too bad, but may not be fatal, so warn only...
@@ -2337,107 +5334,139 @@ static bool
 	return destroyed_wd;
 }
 
-// Handle input data from a successful IPC connection (caller breaks on true).
+// Handle a single IPC command from a client (caller closes the connection on true).
 static bool
-    handle_ipc(int data_fd)
+    handle_ipc(IpcSession* session, const char* ipc_cmd, size_t cmd_len)
 {
 	// Eh, recycle PIPE_BUF, it should be more than enough for our needs.
-	char buf[PIPE_BUF] = { 0 };
-
-	// We don't actually know the size of the input data, so, best effort here.
-	ssize_t len = xread(data_fd, buf, sizeof(buf) - 1U);
-	if (len < 0) {
-		// Only actual failures are left, xread handles the rest
-		PFLOG(LOG_WARNING, "read: %m");
-		FB_PRINT("[KFMon] read failed ?!");
-		// Signal our polling to close the connection, don't retry, as we risk failing here again otherwise.
-		return true;
-	}
-
-	if (len == 0) {
-		// EoF, we're done, signal our polling to close the connection
-		return true;
-	}
+	// NOTE: We work on a copy, because we recycle it to build our replies.
+	char    buf[PIPE_BUF] = { 0 };
+	ssize_t len           = (ssize_t) MIN(cmd_len, sizeof(buf) - 1U);
+	memcpy(buf, ipc_cmd, (size_t) len);
+	kfStats.ipc_commands++;
 
 	// Handle the supported commands
-	if ((strncasecmp(buf, "list", 4) == 0) || (strncasecmp(buf, "gui-list", 8) == 0)) {
-		LOG(LOG_INFO, "Processing IPC watch listing request");
+	if ((strncasecmp(buf, "list-if-changed", 15) == 0) || (strncasecmp(buf, "gui-list-if-changed", 19) == 0)) {
 		// Discriminate gui-list
-		bool gui = (buf[0] == 'g' || buf[0] == 'G');
-
-		// Reply with a list of active watches, format is id:basename(filename):label (separated by a LF)
-		//                                             or id:basename(filename) if the watch has no label set.
-		for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
-			if (!watchConfig[watch_idx].is_active) {
-				continue;
+		bool     gui        = (buf[0] == 'g' || buf[0] == 'G');
+		uint32_t generation = 0U;
+		int      n          = 0;
+		// NOTE: We matched the command case-insensitively, so, only parse what comes after it.
+		size_t   prefix_len = gui ? 19U : 15U;
+		if (buf[prefix_len] == ':') {
+			n = sscanf(buf + prefix_len + 1U, "%u", &generation);
+		}
+
+		int  packet_len = 0;
+		bool changed    = false;
+		if (n != 1) {
+			CLOG(LOG_CAT_IPC,
+			     LOG_WARNING,
+			     "Malformed %slist-if-changed command: %.*s",
+			     gui ? "gui-" : "",
+			     (int) len,
+			     buf);
+			packet_len = snprintf(buf,
+					      sizeof(buf),
+					      "ERR_MALFORMED_CMD\nExpected format is %slist-if-changed:generation\n",
+					      gui ? "gui-" : "");
+		} else {
+			refresh_watch_lists();
+			if (generation == watchLists.generation) {
+				// Nothing to see here, move along
+				packet_len = snprintf(buf, sizeof(buf), "OK_UNCHANGED\n");
+			} else {
+				CLOG(LOG_CAT_IPC,
+				     LOG_INFO,
+				     "Processing IPC watch listing request (generation %u)",
+				     watchLists.generation);
+				// Let the client know what it's getting, so it can ask again later
+				packet_len = snprintf(buf, sizeof(buf), "GENERATION:%u\n", watchLists.generation);
+				changed    = true;
 			}
+		}
 
-			// If it's a gui listing, skip hidden watches
-			if (gui && watchConfig[watch_idx].hidden) {
-				continue;
+		if (changed) {
+			// Make sure we reply with that in full (w/o a NUL, the list follows) to the client.
+			if (queue_reply(session, buf, (size_t) (packet_len)) < 0) {
+				// Don't retry on write failures, just signal our polling to close the connection
+				return true;
 			}
 
-			// If it has a label, add it in a third field, otherwise, don't even print the extra field separator.
-			int packet_len = 0;
-			if (*watchConfig[watch_idx].label) {
-				packet_len = snprintf(buf,
-						      sizeof(buf),
-						      "%hhu:%s:%s\n",
-						      watch_idx,
-						      basename(watchConfig[watch_idx].filename),
-						      watchConfig[watch_idx].label);
-			} else {
-				packet_len = snprintf(
-				    buf, sizeof(buf), "%hhu:%s\n", watch_idx, basename(watchConfig[watch_idx].filename));
+			// w/ NUL
+			if (queue_reply(session,
+					gui ? watchLists.gui_list : watchLists.list,
+					gui ? watchLists.gui_list_len : watchLists.list_len) < 0) {
+				// Don't retry on write failures, just signal our polling to close the connection
+				return true;
 			}
-			// Make sure we reply with that in full (w/o a NUL, we're not done yet) to the client.
-			if (send_in_full(data_fd, buf, (size_t) (packet_len)) < 0) {
-				// Only actual failures are left, so we're pretty much done
-				if (errno == EPIPE) {
-					PFLOG(LOG_WARNING, "Client closed the connection early");
-				} else {
-					PFLOG(LOG_WARNING, "send: %m");
-					FB_PRINT("[KFMon] send failed ?!");
-				}
+		} else {
+			// w/ NUL
+			if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
 				// Don't retry on write failures, just signal our polling to close the connection
 				return true;
 			}
-			// NOTE: In debug mode, add a delay to test handling of replies split across multiple reads in clients...
-#ifdef DEBUG
-			const struct timespec zzz = { 0L, 250000000L };
-			nanosleep(&zzz, NULL);
-#endif
 		}
-		// Now that we're done, send a final NUL, just to be nice.
-		buf[0] = '\0';
-		if (send_in_full(data_fd, buf, 1U) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
-			}
+	} else if ((strncasecmp(buf, "list", 4) == 0) || (strncasecmp(buf, "gui-list", 8) == 0)) {
+		CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC watch listing request");
+		// Discriminate gui-list
+		bool gui = (buf[0] == 'g' || buf[0] == 'G');
+
+		// Reply with a list of active watches (c.f., refresh_watch_lists for the format)
+		refresh_watch_lists();
+		// w/ NUL
+		if (queue_reply(session,
+				gui ? watchLists.gui_list : watchLists.list,
+				gui ? watchLists.gui_list_len : watchLists.list_len) < 0) {
 			// Don't retry on write failures, just signal our polling to close the connection
 			return true;
 		}
 	} else if ((strncmp(buf, "start", 5) == 0) || (strncmp(buf, "force-start", 11) == 0) ||
-		   (strncmp(buf, "trigger", 7) == 0) || (strncmp(buf, "force-trigger", 13) == 0)) {
+		   (strncmp(buf, "trigger", 7) == 0) || (strncmp(buf, "force-trigger", 13) == 0) ||
+		   (strncmp(buf, "queue-start", 11) == 0) || (strncmp(buf, "queue-trigger", 13) == 0)) {
 		// Discriminate force-*
-		bool    force                          = (buf[0] == 'f');
+		bool               force                          = (buf[0] == 'f');
+		// Discriminate queue-*
+		bool               queue                          = (buf[0] == 'q');
 		// Discriminate trigger from start
-		bool    trigger                        = (force ? buf[6] == 't' : buf[0] == 't');
+		bool               trigger                        = ((force || queue) ? buf[6] == 't' : buf[0] == 't');
+		// Discriminate *-wait
+		bool               wait_for_exit                  = trigger ? (strncmp(buf, "trigger-wait", 12) == 0)
+									    : (strncmp(buf, "start-wait", 10) == 0);
+		// For the logs & replies
+		const char*        mode                           = force ? "force " : (queue ? "queue " : "");
+		const char*        prefix                         = force ? "force-" : (queue ? "queue-" : "");
+		const char*        infix                          = wait_for_exit ? "-wait" : "";
+		const char*        suffix                         = queue ? "[:ttl]" : "";
 		// Pull the actual id out of there. Could have went with strtok, too.
-		uint8_t watch_id                       = WATCH_MAX;
-		char    watch_basename[CFG_SZ_MAX + 1] = { 0 };
-		errno                                  = 0;
-		int n                                  = 0;
+		uint8_t            watch_id                       = WATCH_MAX;
+		char               watch_basename[CFG_SZ_MAX + 1] = { 0 };
+		// queue-* accepts an optional TTL (in seconds)
+		unsigned short int ttl                            = 0U;
+		errno                                             = 0;
+		int n                                             = 0;
 		if (force) {
 			if (trigger) {
 				n = sscanf(buf, "force-trigger:%" CFG_SZ_MAX_STR "s", watch_basename);
 			} else {
 				n = sscanf(buf, "force-start:%hhu", &watch_id);
 			}
+		} else if (queue) {
+			if (trigger) {
+				n = sscanf(buf, "queue-trigger:%" CFG_SZ_MAX_STR "[^:]:%hu", watch_basename, &ttl);
+			} else {
+				n = sscanf(buf, "queue-start:%hhu:%hu", &watch_id, &ttl);
+			}
+			// Honor kfmon.ini's queue_ttl if the request didn't specify one, and fall back to our own default otherwise.
+			if (ttl == 0U) {
+				ttl = daemonConfig.queue_ttl > 0U ? daemonConfig.queue_ttl : QUEUE_TTL_DEFAULT;
+			}
+		} else if (wait_for_exit) {
+			if (trigger) {
+				n = sscanf(buf, "trigger-wait:%" CFG_SZ_MAX_STR "s", watch_basename);
+			} else {
+				n = sscanf(buf, "start-wait:%hhu", &watch_id);
+			}
 		} else {
 			if (trigger) {
 				n = sscanf(buf, "trigger:%" CFG_SZ_MAX_STR "s", watch_basename);
@@ -2450,7 +5479,7 @@ static bool
 		//       as failing to get a reply in time is the only way a client can figure out that KFMon
 		//       is already busy with a previous IPC connection...
 		int packet_len = 0;
-		if (n == 1) {
+		if (n >= 1) {
 			// Got it! Now check if it's valid...
 			bool found_watch_idx = false;
 			for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
@@ -2477,30 +5506,34 @@ static bool
 			if (!found_watch_idx) {
 				// Invalid or inactive watch, can't do anything.
 				if (trigger) {
-					LOG(LOG_WARNING,
-					    "Received a request to %strigger an invalid watch '%s'",
-					    force ? "force " : "",
-					    watch_basename);
+					CLOG(LOG_CAT_IPC,
+					     LOG_WARNING,
+					     "Received a request to %strigger an invalid watch '%s'",
+					     mode,
+					     watch_basename);
 				} else {
-					LOG(LOG_WARNING,
-					    "Received a request to %sstart an invalid watch idx %hhu",
-					    force ? "force " : "",
-					    watch_id);
+					CLOG(LOG_CAT_IPC,
+					     LOG_WARNING,
+					     "Received a request to %sstart an invalid watch idx %hhu",
+					     mode,
+					     watch_id);
 				}
 				packet_len = snprintf(buf, sizeof(buf), "ERR_INVALID_ID\n");
 			} else {
 				// Go ahead, we thankfully have a few less sanity checks to deal with than handle_events,
 				// because no SQL ;).
 				if (trigger) {
-					LOG(LOG_INFO,
-					    "Processing IPC request to %strigger watch '%s'",
-					    force ? "force " : "",
-					    watch_basename);
+					CLOG(LOG_CAT_IPC,
+					     LOG_INFO,
+					     "Processing IPC request to %strigger watch '%s'",
+					     mode,
+					     watch_basename);
 				} else {
-					LOG(LOG_INFO,
-					    "Processing IPC request to %sstart watch idx %hhu",
-					    force ? "force " : "",
-					    watch_id);
+					CLOG(LOG_CAT_IPC,
+					     LOG_INFO,
+					     "Processing IPC request to %sstart watch idx %hhu",
+					     mode,
+					     watch_id);
 				}
 
 				// See handle_events for the logic behind spawn blocking & co.
@@ -2514,8 +5547,9 @@ static bool
 
 				// Can't force something that is itself a spawn blocker...
 				if (force && watchConfig[watch_id].block_spawns) {
-					LOG(LOG_NOTICE,
-					    "Dropping the force flag, as the requested watch is a spawn blocker");
+					CLOG(LOG_CAT_IPC,
+					     LOG_NOTICE,
+					     "Dropping the force flag, as the requested watch is a spawn blocker");
 					force = false;
 				}
 
@@ -2524,19 +5558,67 @@ static bool
 				    (!force && !is_watch_spawned && !is_blocker_spawned && !is_spawn_blocked)) {
 					// Skipping the SQL checks implies we don't need the "may still be processing"
 					// logic, either ;).
-					LOG(LOG_INFO,
-					    "Preparing to spawn %s for watch idx %hhu . . .",
-					    watchConfig[watch_id].action,
-					    watch_id);
+					CLOG(LOG_CAT_IPC,
+					     LOG_INFO,
+					     "Preparing to spawn %s for watch idx %hhu . . .",
+					     watchConfig[watch_id].action,
+					     watch_id);
 					if (watchConfig[watch_id].block_spawns) {
-						LOG(LOG_NOTICE,
-						    "%s is flagged as a spawn blocker, it will prevent *any* event from triggering a spawn while it is still running!",
-						    watchConfig[watch_id].action);
+						CLOG(LOG_CAT_IPC,
+						     LOG_NOTICE,
+						     "%s is flagged as a spawn blocker, it will prevent *any* event from triggering a spawn while it is still running!",
+						     watchConfig[watch_id].action);
 					}
 					// We're using execvp()...
 					char* const cmd[] = { watchConfig[watch_id].action, NULL };
-					spawn(cmd, watch_id);
-					packet_len = snprintf(buf, sizeof(buf), "OK\n");
+					pid_t       pid   = spawn(cmd, watch_id, SPAWN_FROM_IPC);
+					if (pid == -1) {
+						packet_len = snprintf(buf, sizeof(buf), "ERR_EXEC_FAILED\n");
+					} else if (wait_for_exit) {
+						// We'll reply once it has been reaped (c.f., complete_exit_waits)
+						CLOG(LOG_CAT_IPC,
+						     LOG_INFO,
+						     "Waiting for process %ld to exit before replying to IPC client PID %ld (%s)",
+						     (long) pid,
+						     (long) session->ucred.pid,
+						     session->pname);
+						session->wait_pid = pid;
+						session->wait_id  = session->req_id;
+					} else {
+						packet_len = snprintf(buf, sizeof(buf), "OK\n");
+					}
+				} else if (queue) {
+					// Try again whenever something exits, until the TTL runs out
+					int ret = queue_launch(watch_id, SPAWN_FROM_IPC, ttl);
+					if (ret == 0) {
+						CLOG(LOG_CAT_IPC,
+						     LOG_INFO,
+						     "Queued %s for watch idx %hhu for up to %hus",
+						     watchConfig[watch_id].action,
+						     watch_id,
+						     ttl);
+						if (daemonConfig.with_notifications) {
+							FB_PRINTF("[KFMon] Queued %s", basename(watchConfig[watch_id].action));
+						}
+						packet_len = snprintf(buf, sizeof(buf), "OK_QUEUED\n");
+					} else if (ret > 0) {
+						CLOG(LOG_CAT_IPC,
+						     LOG_INFO,
+						     "Watch idx %hhu (%s) is already queued",
+						     watch_id,
+						     watchConfig[watch_id].filename);
+						packet_len = snprintf(buf, sizeof(buf), "WARN_ALREADY_QUEUED\n");
+					} else {
+						CLOG(LOG_CAT_IPC,
+						     LOG_WARNING,
+						     "Launch queue is full (%d), can't queue watch idx %hhu (%s)!",
+						     QUEUE_MAX,
+						     watch_id,
+						     watchConfig[watch_id].filename);
+						FB_PRINTF("[KFMon] Not spawning %s: queue is full!",
+							  basename(watchConfig[watch_id].action));
+						packet_len = snprintf(buf, sizeof(buf), "ERR_QUEUE_FULL\n");
+					}
 				} else {
 					if (is_watch_spawned) {
 						pid_t spid;
@@ -2544,26 +5626,32 @@ static bool
 						spid = get_spawn_pid_for_watch(watch_id);
 						pthread_mutex_unlock(&ptlock);
 
-						LOG(LOG_INFO,
-						    "As watch idx %hhu (%s) still has a spawned process (%ld -> %s) running, we won't be spawning another instance of it!",
-						    watch_id,
-						    watchConfig[watch_id].filename,
-						    (long) spid,
-						    watchConfig[watch_id].action);
+						CLOG(LOG_CAT_IPC,
+						     LOG_INFO,
+						     "As watch idx %hhu (%s) still has a spawned process (%ld -> %s) running, we won't be spawning another instance of it!",
+						     watch_id,
+						     watchConfig[watch_id].filename,
+						     (long) spid,
+						     watchConfig[watch_id].action);
 						FB_PRINTF("[KFMon] Not spawning %s: still running!",
 							  basename(watchConfig[watch_id].action));
+						publish_blocked_event(watch_id, "running");
 						packet_len = snprintf(buf, sizeof(buf), "WARN_ALREADY_RUNNING\n");
 					} else if (!force && is_blocker_spawned) {
-						LOG(LOG_INFO,
-						    "As a spawn blocker process is currently running, we won't be spawning anything else to prevent unwanted behavior!");
+						CLOG(LOG_CAT_IPC,
+						     LOG_INFO,
+						     "As a spawn blocker process is currently running, we won't be spawning anything else to prevent unwanted behavior!");
 						FB_PRINTF("[KFMon] Not spawning %s: blocked!",
 							  basename(watchConfig[watch_id].action));
+						publish_blocked_event(watch_id, "blocker");
 						packet_len = snprintf(buf, sizeof(buf), "WARN_SPAWN_BLOCKED\n");
 					} else if (!force && is_spawn_blocked) {
-						LOG(LOG_INFO,
-						    "As the global spawn inhibiter flag is present, we won't be spawning anything!");
+						CLOG(LOG_CAT_IPC,
+						     LOG_INFO,
+						     "As the global spawn inhibiter flag is present, we won't be spawning anything!");
 						FB_PRINTF("[KFMon] Not spawning %s: inhibited!",
 							  basename(watchConfig[watch_id].action));
+						publish_blocked_event(watch_id, "inhibited");
 						packet_len = snprintf(buf, sizeof(buf), "WARN_SPAWN_INHIBITED\n");
 					}
 				}
@@ -2574,39 +5662,349 @@ static bool
 			if (trigger) {
 				packet_len = snprintf(buf,
 						      sizeof(buf),
-						      "ERR_REALLY_MALFORMED_CMD\nExpected format is %strigger:name\n",
-						      force ? "force-" : "");
+						      "ERR_REALLY_MALFORMED_CMD\nExpected format is %strigger%s:name%s\n",
+						      prefix,
+						      infix,
+						      suffix);
 			} else {
 				packet_len = snprintf(buf,
 						      sizeof(buf),
-						      "ERR_REALLY_MALFORMED_CMD\nExpected format is %sstart:id\n",
-						      force ? "force-" : "");
+						      "ERR_REALLY_MALFORMED_CMD\nExpected format is %sstart%s:id%s\n",
+						      prefix,
+						      infix,
+						      suffix);
 			}
 		} else {
 			if (trigger) {
-				LOG(LOG_WARNING, "Malformed trigger command: %.*s", (int) len, buf);
+				CLOG(LOG_CAT_IPC, LOG_WARNING, "Malformed trigger command: %.*s", (int) len, buf);
 				packet_len = snprintf(buf,
 						      sizeof(buf),
-						      "ERR_MALFORMED_CMD\nExpected format is %strigger:name\n",
-						      force ? "force-" : "");
+						      "ERR_MALFORMED_CMD\nExpected format is %strigger%s:name%s\n",
+						      prefix,
+						      infix,
+						      suffix);
 			} else {
-				LOG(LOG_WARNING, "Malformed start command: %.*s", (int) len, buf);
+				CLOG(LOG_CAT_IPC, LOG_WARNING, "Malformed start command: %.*s", (int) len, buf);
 				packet_len = snprintf(buf,
 						      sizeof(buf),
-						      "ERR_MALFORMED_CMD\nExpected format is %sstart:id\n",
-						      force ? "force-" : "");
+						      "ERR_MALFORMED_CMD\nExpected format is %sstart%s:id%s\n",
+						      prefix,
+						      infix,
+						      suffix);
 			}
 		}
 
-		// Reply with the status (w/ NUL)
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
+		// Reply with the status (w/ NUL), unless it's deferred until the process exits
+		if (session->wait_pid == 0 && queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "proto", 5) == 0) {
+		// Switch this connection to another protocol version (c.f., utils/ipc_proto.h)
+		uint8_t version    = 0U;
+		int     packet_len = 0;
+		if (sscanf(buf, "proto:%hhu", &version) == 1 &&
+		    (version == KFMON_IPC_PROTO_VERSION || (version == 1U && session->proto < 2U))) {
+			CLOG(LOG_CAT_IPC, LOG_INFO, "Switching IPC connection to protocol v%hhu", version);
+			packet_len = snprintf(buf, sizeof(buf), "OK\n");
+		} else {
+			CLOG(LOG_CAT_IPC, LOG_WARNING, "Unsupported IPC protocol switch request: %.*s", (int) len, buf);
+			version    = 0U;
+			packet_len = snprintf(buf, sizeof(buf), "ERR_INVALID_PROTO\nSupported protocol versions: 1, 2\n");
+		}
+
+		// w/ NUL
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+		// NOTE: Only switch *after* the reply was queued, as it's the last one in the previous format.
+		if (version > 0U) {
+			session->proto = version;
+		}
+	} else if (strncasecmp(buf, "subscribe", 9) == 0) {
+		// Start pushing events to this connection, until it's closed
+		CLOG(LOG_CAT_IPC,
+		     LOG_INFO,
+		     "Subscribing IPC client PID %ld (%s) to events",
+		     (long) session->ucred.pid,
+		     session->pname);
+		session->is_subscribed = true;
+
+		// w/ NUL
+		int packet_len = snprintf(buf, sizeof(buf), "OK\n");
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "stats:dump", 10) == 0) {
+		CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC metrics dump request");
+		int packet_len = 0;
+		if (stats_dump() == EXIT_SUCCESS) {
+			packet_len = snprintf(buf, sizeof(buf), "OK\n");
+		} else {
+			packet_len = snprintf(buf, sizeof(buf), "ERR_STATS_FAILED\n");
+		}
+
+		// w/ NUL
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "stats", 5) == 0) {
+		CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC metrics request");
+
+		uint64_t reapers_cpu_us;
+		pthread_mutex_lock(&ptlock);
+		reapers_cpu_us = kfStats.reapers_cpu_us;
+		pthread_mutex_unlock(&ptlock);
+		sqlite3_int64 sql_mem    = 0;
+		sqlite3_int64 sql_mem_hi = 0;
+		sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &sql_mem, &sql_mem_hi, 0);
+
+		// Reply with our counters, one per line (separated by a LF), format is name:value
+		int packet_len = snprintf(
+		    buf,
+		    sizeof(buf),
+		    "inotify_open:%llu\ninotify_close:%llu\ninotify_unmount:%llu\n"
+		    "inotify_ignored:%llu\ninotify_overflow:%llu\n"
+		    "db_checks:%llu\ndb_checks_skipped:%llu\ndb_errors:%llu\nspawns:%llu\nexec_failures:%llu\n"
+		    "blocked_triggers:%llu\nqueued_triggers:%llu\ndropped_triggers:%llu\nwatchdog_kills:%llu\n"
+		    "ipc_connections:%llu\nipc_commands:%llu\nipc_errors:%llu\nipc_dropped:%llu\n"
+		    "cpu_main_us:%llu\ncpu_reapers_us:%llu\ncpu_all_us:%llu\n"
+		    "sqlite_memory:%lld\nsqlite_memory_highwater:%lld\n",
+		    (unsigned long long int) kfStats.inotify_open,
+		    (unsigned long long int) kfStats.inotify_close,
+		    (unsigned long long int) kfStats.inotify_unmount,
+		    (unsigned long long int) kfStats.inotify_ignored,
+		    (unsigned long long int) kfStats.inotify_overflow,
+		    (unsigned long long int) kfStats.db_checks,
+		    (unsigned long long int) kfStats.db_checks_skipped,
+		    (unsigned long long int) kfStats.db_errors,
+		    (unsigned long long int) kfStats.spawns,
+		    (unsigned long long int) kfStats.exec_failures,
+		    (unsigned long long int) kfStats.blocked_triggers,
+		    (unsigned long long int) kfStats.queued_triggers,
+		    (unsigned long long int) kfStats.dropped_triggers,
+		    (unsigned long long int) kfStats.watchdog_kills,
+		    (unsigned long long int) kfStats.ipc_connections,
+		    (unsigned long long int) kfStats.ipc_commands,
+		    (unsigned long long int) kfStats.ipc_errors,
+		    (unsigned long long int) kfStats.ipc_dropped,
+		    (unsigned long long int) get_thread_cpu_us(CLOCK_THREAD_CPUTIME_ID),
+		    (unsigned long long int) reapers_cpu_us,
+		    (unsigned long long int) get_thread_cpu_us(CLOCK_PROCESS_CPUTIME_ID),
+		    (long long int) sql_mem,
+		    (long long int) sql_mem_hi);
+		// Make sure we reply with that in full (w/o a NUL, we're not done yet) to the client.
+		if (queue_reply(session, buf, (size_t) (packet_len)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+
+		// Followed by our latency histograms, one per line, format is
+		// latency_name:count:sum_us:b0,b1,...
+		// Where bucket n counts the samples in (2^(n-1), 2^n] µs, except for the last one, which is open-ended.
+		for (LatencyKind kind = LATENCY_DECISION; kind < LATENCY_MAX; kind++) {
+			const LatencyHistogram* restrict hist = &kfStats.latency[kind];
+
+			packet_len = snprintf(buf,
+					      sizeof(buf),
+					      "latency_%s:%llu:%llu:",
+					      latency_kind_to_str(kind),
+					      (unsigned long long int) hist->count,
+					      (unsigned long long int) hist->sum_us);
+			for (uint8_t n = 0U; n < STATS_BUCKETS; n++) {
+				packet_len += snprintf(buf + packet_len,
+						       sizeof(buf) - (size_t) packet_len,
+						       n + 1U < STATS_BUCKETS ? "%llu," : "%llu\n",
+						       (unsigned long long int) hist->buckets[n]);
+			}
+			if (queue_reply(session, buf, (size_t) (packet_len)) < 0) {
+				// Don't retry on write failures, just signal our polling to close the connection
+				return true;
+			}
+		}
+		// Now that we're done, send a final NUL, just to be nice.
+		buf[0] = '\0';
+		if (queue_reply(session, buf, 1U) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "history", 7) == 0) {
+		CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC spawn history request");
+
+		// Take a snapshot of the history ring, so we don't hold the lock while we talk to the client
+		struct spawn_history history;
+		pthread_mutex_lock(&ptlock);
+		history = SH;
+		pthread_mutex_unlock(&ptlock);
+
+		// Reply with our most recent spawns, oldest first, one per line (separated by a LF), format is
+		// pid:watch_idx:basename(filename):source:start_ms:end_ms:state:code
+		// Where source is either inotify or ipc, timestamps are based on the monotonic clock (end_ms is 0 if it's still running),
+		// and state is one of running, exited or killed, with code being the exit code or the signal number,
+		// respectively, or lost if we failed to reap it (code is then -1).
+		for (uint8_t n = 0U; n < history.count; n++) {
+			const SpawnRecord* restrict record =
+			    &history.records[(history.next + HISTORY_MAX - history.count + n) % HISTORY_MAX];
+
+			const char* state = exit_state_to_str(record);
+			int packet_len = snprintf(buf,
+						  sizeof(buf),
+						  "%ld:%hhd:%s:%s:%lld:%lld:%s:%d\n",
+						  (long) record->pid,
+						  record->watch_idx,
+						  record->name,
+						  spawn_source_to_str(record->source),
+						  (long long int) record->start_ts.tv_sec * 1000LL + record->start_ts.tv_nsec / 1000000L,
+						  (long long int) record->end_ts.tv_sec * 1000LL + record->end_ts.tv_nsec / 1000000L,
+						  state,
+						  record->status);
+			// Make sure we reply with that in full (w/o a NUL, we're not done yet) to the client.
+			if (queue_reply(session, buf, (size_t) (packet_len)) < 0) {
+				// Don't retry on write failures, just signal our polling to close the connection
+				return true;
+			}
+		}
+		// Now that we're done, send a final NUL, just to be nice.
+		buf[0] = '\0';
+		if (queue_reply(session, buf, 1U) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "trace", 5) == 0) {
+		// Toggle launch tracing
+		int packet_len = 0;
+		if (strncasecmp(buf, "trace:on", 8) == 0) {
+			CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC request to enable launch tracing");
+			if (trace_enable() == EXIT_SUCCESS) {
+				packet_len = snprintf(buf, sizeof(buf), "OK\n");
 			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
+				packet_len = snprintf(buf, sizeof(buf), "ERR_TRACE_FAILED\n");
+			}
+		} else if (strncasecmp(buf, "trace:off", 9) == 0) {
+			CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC request to disable launch tracing");
+			trace_disable();
+			packet_len = snprintf(buf, sizeof(buf), "OK\n");
+		} else {
+			CLOG(LOG_CAT_IPC, LOG_WARNING, "Malformed trace command: %.*s", (int) len, buf);
+			packet_len = snprintf(buf, sizeof(buf), "ERR_MALFORMED_CMD\nExpected format is trace:on or trace:off\n");
+		}
+
+		// w/ NUL
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "log-level", 9) == 0) {
+		// Query or tweak our log levels
+		int packet_len = 0;
+		if (buf[9] == '\0' || buf[9] == '\n') {
+			CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC log levels listing request");
+			packet_len = format_log_levels(buf, sizeof(buf) - 2U, "\n");
+			buf[packet_len++] = '\n';
+			buf[packet_len]   = '\0';
+		} else {
+			// Either log-level:level (for every category), or log-level:category:level
+			char    cat_name[16]   = { 0 };
+			char    level_name[16] = { 0 };
+			int     cat            = LOG_CAT_MAX;
+			uint8_t level;
+			int     n              = 0;
+			// NOTE: We matched the command case-insensitively, so, only parse what comes after it.
+			if (buf[9] == ':') {
+				n = sscanf(buf + 10, "%15[^:\n]:%15[^:\n]", cat_name, level_name);
+			}
+			if (n == 2) {
+				cat = parse_log_category(cat_name);
+			} else if (n == 1) {
+				memcpy(level_name, cat_name, sizeof(level_name));
+			}
+			if (n < 1 || cat < 0 || parse_log_level(level_name, &level) < 0) {
+				CLOG(LOG_CAT_IPC, LOG_WARNING, "Malformed log-level command: %.*s", (int) len, buf);
+				packet_len = snprintf(
+				    buf,
+				    sizeof(buf),
+				    "ERR_MALFORMED_CMD\nExpected format is log-level, log-level:level or log-level:category:level\n");
+			} else {
+				if (cat == LOG_CAT_MAX) {
+					for (uint8_t i = LOG_CAT_GENERAL; i < LOG_CAT_MAX; i++) {
+						__atomic_store_n(&logLevels[i], level, __ATOMIC_RELAXED);
+					}
+				} else {
+					__atomic_store_n(&logLevels[cat], level, __ATOMIC_RELAXED);
+				}
+				// NOTE: Use RAWLOG, as we might have just silenced ourselves ;).
+				RAWLOG(LOG_NOTICE,
+				       "Log level of %s set to %s over IPC",
+				       cat == LOG_CAT_MAX ? "every category" : cat_name,
+				       log_level_to_str(level));
+				packet_len = snprintf(buf, sizeof(buf), "OK\n");
+			}
+		}
+
+		// w/ NUL
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "log-dump", 8) == 0) {
+		// Reply with the tail end of our in-memory log
+		unsigned int lines      = 0U;
+		int          packet_len = 0;
+		if (!daemonConfig.log_to_ram) {
+			packet_len = snprintf(buf, sizeof(buf), "ERR_LOG_NOT_IN_RAM\n");
+		} else if (buf[8] == ':' && sscanf(buf, "log-dump:%u", &lines) != 1) {
+			CLOG(LOG_CAT_IPC, LOG_WARNING, "Malformed log-dump command: %.*s", (int) len, buf);
+			packet_len = snprintf(buf, sizeof(buf), "ERR_MALFORMED_CMD\nExpected format is log-dump or log-dump:lines\n");
+		} else {
+			CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC log dump request (%u lines)", lines);
+			// Make sure it's up to date first
+			log_flush();
+
+			char* dump = malloc(LOG_DUMP_SZ_MAX);
+			if (!dump) {
+				PFLOG(LOG_WARNING, "malloc: %m");
+				return true;
+			}
+			pthread_mutex_lock(&loglock);
+			size_t dump_len = ramlog_tail(dump, LOG_DUMP_SZ_MAX, lines);
+			pthread_mutex_unlock(&loglock);
+
+			// w/o a NUL, we're not done yet
+			int ret = queue_reply(session, dump, dump_len);
+			free(dump);
+			if (ret < 0) {
+				// Don't retry on write failures, just signal our polling to close the connection
+				return true;
+			}
+		}
+
+		// Error, or a final NUL, just to be nice.
+		if (packet_len == 0) {
+			buf[0] = '\0';
+		}
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
+			// Don't retry on write failures, just signal our polling to close the connection
+			return true;
+		}
+	} else if (strncasecmp(buf, "log-save", 8) == 0) {
+		// Flush our in-memory log to the userstore
+		int packet_len = 0;
+		if (!daemonConfig.log_to_ram) {
+			packet_len = snprintf(buf, sizeof(buf), "ERR_LOG_NOT_IN_RAM\n");
+		} else {
+			CLOG(LOG_CAT_IPC, LOG_INFO, "Processing IPC log save request");
+			if (log_save_ram("on request") == EXIT_SUCCESS) {
+				packet_len = snprintf(buf, sizeof(buf), "OK\n");
+			} else {
+				packet_len = snprintf(buf, sizeof(buf), "ERR_LOG_SAVE_FAILED\n");
 			}
+		}
+
+		// w/ NUL
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
 			// Don't retry on write failures, just signal our polling to close the connection
 			return true;
 		}
@@ -2615,14 +6013,7 @@ static bool
 		int packet_len = snprintf(buf, sizeof(buf), "KFMon %s\n", KFMON_VERSION);
 
 		// w/ NUL
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
-			}
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
 			// Don't retry on write failures, just signal our polling to close the connection
 			return true;
 		}
@@ -2638,34 +6029,25 @@ static bool
 					  fbink_version());
 
 		// w/ NUL
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
-			}
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
 			// Don't retry on write failures, just signal our polling to close the connection
 			return true;
 		}
 	} else {
-		LOG(LOG_WARNING, "Received an invalid/unsupported %zd bytes IPC command: %.*s", len, (int) len, buf);
+		CLOG(LOG_CAT_IPC,
+		     LOG_WARNING,
+		     "Received an invalid/unsupported %zd bytes IPC command: %.*s",
+		     len,
+		     (int) len,
+		     buf);
 		// Reply with a list of valid commands, that should be good enough, no need for a full fledged help command.
 		int packet_len = snprintf(
 		    buf,
 		    sizeof(buf),
-		    "ERR_INVALID_CMD\nComma separated list of valid commands: version, full-version, list, gui-list, start, force-start, trigger, force-trigger\n");
+		    "ERR_INVALID_CMD\nComma separated list of valid commands: version, full-version, list, gui-list, start, force-start, queue-start, trigger, force-trigger, queue-trigger, start-wait, trigger-wait, list-if-changed, gui-list-if-changed, history, subscribe, stats, trace, log-level, log-dump, log-save, proto\n");
 
 		// w/ NUL
-		if (send_in_full(data_fd, buf, (size_t) (packet_len + 1)) < 0) {
-			// Only actual failures are left, so we're pretty much done
-			if (errno == EPIPE) {
-				PFLOG(LOG_WARNING, "Client closed the connection early");
-			} else {
-				PFLOG(LOG_WARNING, "send: %m");
-				FB_PRINT("[KFMon] send failed ?!");
-			}
+		if (queue_reply(session, buf, (size_t) (packet_len + 1)) < 0) {
 			// Don't retry on write failures, just signal our polling to close the connection
 			return true;
 		}
@@ -2765,16 +6147,249 @@ static void
 	}
 }
 
-// Handle a connection attempt on socket 'conn_fd'.
+// Push an event to every subscribed IPC session (c.f., the subscribe command)
+static void
+    publish_event(const char* fmt, ...)
+{
+	char    buf[PIPE_BUF];
+	va_list args;
+	va_start(args, fmt);
+	int len = vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	if (len < 0) {
+		return;
+	}
+	len = MIN(len, (int) sizeof(buf) - 1);
+
+	for (uint8_t i = 0U; i < IPC_SESSIONS_MAX; i++) {
+		IpcSession* session = &ipcSessions[i];
+		if (session->fd == -1 || !session->is_subscribed || session->is_dead) {
+			continue;
+		}
+
+		int rc;
+		if (session->proto >= 2U) {
+			rc = queue_frame(session, 0U, IPC_FRAME_EVENT, buf, (size_t) len);
+		} else {
+			// w/ NUL
+			rc = queue_output(session, buf, (size_t) len + 1U);
+		}
+		// NOTE: We may be running on behalf of this very session (e.g., it sent a start command),
+		//       so we can't close it here, let expire_sessions take care of it.
+		if (rc < 0) {
+			session->is_dead = true;
+		}
+	}
+}
+
+static void
+    publish_watch_event(const char* kind, uint8_t watch_idx)
+{
+	publish_event("EVENT:%s:%hhu:%s\n", kind, watch_idx, basename(watchConfig[watch_idx].filename));
+}
+
+static void
+    publish_blocked_event(uint8_t watch_idx, const char* reason)
+{
+	kfStats.blocked_triggers++;
+	journal_blocked(watch_idx, reason);
+	publish_event("EVENT:blocked:%hhu:%s:%s\n", watch_idx, basename(watchConfig[watch_idx].filename), reason);
+}
+
+// Publish the exits the reapers have recorded in the spawn history since the last time we checked
+static void
+    publish_exit_events(void)
+{
+	// NOTE: Don't hold ptlock while we're pushing stuff to the sessions, so, copy what we need first.
+	SpawnRecord records[HISTORY_MAX];
+	uint8_t     count = 0U;
+	pthread_mutex_lock(&ptlock);
+	for (uint8_t n = 0U; n < SH.count; n++) {
+		SpawnRecord* restrict record = &SH.records[(SH.next + HISTORY_MAX - SH.count + n) % HISTORY_MAX];
+		if (!record->has_exited || record->was_published) {
+			continue;
+		}
+		record->was_published = true;
+		records[count++]      = *record;
+	}
+	pthread_mutex_unlock(&ptlock);
+
+	for (uint8_t n = 0U; n < count; n++) {
+		const SpawnRecord* record = &records[n];
+		publish_event("EVENT:exit:%hhd:%s:%ld:%s:%d\n",
+			      record->watch_idx,
+			      record->name,
+			      (long) record->pid,
+			      exit_state_to_str(record),
+			      record->status);
+	}
+}
+
+// Flag the serialized watch lists as outdated, they'll be rebuilt the next time they're needed
+static void
+    invalidate_watch_lists(void)
+{
+	// Nobody has seen the current generation yet, no need to bump it again
+	if (watchLists.is_stale) {
+		return;
+	}
+
+	watchLists.generation++;
+	watchLists.is_stale = true;
+}
+
+// Rebuild the serialized watch lists, if need be.
+// Format is id:basename(filename):label (separated by a LF)
+//        or id:basename(filename) if the watch has no label set,
+// followed by a final NUL. Hidden watches are skipped in the gui flavor.
+static void
+    refresh_watch_lists(void)
+{
+	if (!watchLists.is_stale) {
+		return;
+	}
+
+	size_t list_len     = 0U;
+	size_t gui_list_len = 0U;
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (!watchConfig[watch_idx].is_active) {
+			continue;
+		}
+
+		// If it has a label, add it in a third field, otherwise, don't even print the extra field separator.
+		char* entry     = watchLists.list + list_len;
+		int   entry_len = 0;
+		if (*watchConfig[watch_idx].label) {
+			entry_len = snprintf(entry,
+					     sizeof(watchLists.list) - list_len,
+					     "%hhu:%s:%s\n",
+					     watch_idx,
+					     basename(watchConfig[watch_idx].filename),
+					     watchConfig[watch_idx].label);
+		} else {
+			entry_len = snprintf(entry,
+					     sizeof(watchLists.list) - list_len,
+					     "%hhu:%s\n",
+					     watch_idx,
+					     basename(watchConfig[watch_idx].filename));
+		}
+		// NOTE: WATCH_LIST_SZ is sized for the worst case, so this shouldn't ever truncate.
+		if (entry_len < 0 || (size_t) entry_len >= sizeof(watchLists.list) - list_len) {
+			LOG(LOG_WARNING, "Watch list is full, skipping watch idx %hhu", watch_idx);
+			continue;
+		}
+		list_len += (size_t) entry_len;
+
+		// If it's not hidden, it goes in the gui listing, too
+		if (!watchConfig[watch_idx].hidden) {
+			memcpy(watchLists.gui_list + gui_list_len, entry, (size_t) entry_len);
+			gui_list_len += (size_t) entry_len;
+		}
+	}
+	// w/ NUL
+	watchLists.list[list_len]         = '\0';
+	watchLists.gui_list[gui_list_len] = '\0';
+	watchLists.list_len               = list_len + 1U;
+	watchLists.gui_list_len           = gui_list_len + 1U;
+
+	watchLists.is_stale = false;
+}
+
+// Setup our shared memory status page
+static void
+    init_status_page(void)
+{
+	// NOTE: We're the only writer, everyone else only gets to read it.
+	int fd = shm_open(KFMON_STATUS_PAGE_NAME, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd == -1) {
+		PFLOG(LOG_WARNING, "shm_open: %m");
+		return;
+	}
+	// Make sure the umask didn't get in the way
+	if (fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == -1) {
+		PFLOG(LOG_WARNING, "fchmod: %m");
+	}
+	if (ftruncate(fd, sizeof(*statusPage)) == -1) {
+		PFLOG(LOG_WARNING, "ftruncate: %m");
+		close(fd);
+		shm_unlink(KFMON_STATUS_PAGE_NAME);
+		return;
+	}
+
+	void* page = mmap(NULL, sizeof(*statusPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	// The mapping stays valid after the fd is gone
+	close(fd);
+	if (page == MAP_FAILED) {
+		PFLOG(LOG_WARNING, "mmap: %m");
+		shm_unlink(KFMON_STATUS_PAGE_NAME);
+		return;
+	}
+
+	// Start from scratch, but keep seq going if a previous instance left a page behind, to avoid confusing readers
+	statusPage          = page;
+	uint32_t seq        = statusPage->seq & ~1U;
+	*statusPage         = (const KFMonStatusPage) { 0 };
+	statusPage->seq     = seq;
+	statusPage->version = KFMON_STATUS_PAGE_VERSION;
+	statusPage->pid     = (int32_t) getpid();
+	LOG(LOG_INFO, "Publishing our status page to /dev/shm%s", KFMON_STATUS_PAGE_NAME);
+}
+
+// Refresh the content of our status page (c.f., kfmon_status_page_read for the reader side of the seqlock)
+static void
+    update_status_page(void)
+{
+	if (!statusPage) {
+		return;
+	}
+
+	// Gather everything first, to keep the write section as short as possible
+	KFMonStatusWatch watches[WATCH_MAX];
+	uint8_t          count = 0U;
+	bool             is_blocker_spawned;
+	pthread_mutex_lock(&ptlock);
+	for (uint8_t watch_idx = 0U; watch_idx < WATCH_MAX; watch_idx++) {
+		if (!watchConfig[watch_idx].is_active) {
+			continue;
+		}
+
+		KFMonStatusWatch* restrict watch = &watches[count++];
+		*watch                           = (const KFMonStatusWatch) { 0 };
+		watch->idx                       = watch_idx;
+		watch->is_hidden                 = watchConfig[watch_idx].hidden;
+		watch->is_blocker                = watchConfig[watch_idx].block_spawns;
+		if (is_watch_already_spawned(watch_idx)) {
+			watch->pid = (int32_t) get_spawn_pid_for_watch(watch_idx);
+		}
+		str5cpy(watch->name, sizeof(watch->name), basename(watchConfig[watch_idx].filename), CFG_SZ_MAX, TRUNC);
+		str5cpy(watch->label, sizeof(watch->label), watchConfig[watch_idx].label, CFG_SZ_MAX, TRUNC);
+	}
+	is_blocker_spawned = is_blocker_running();
+	pthread_mutex_unlock(&ptlock);
+	bool is_spawn_blocked = are_spawns_blocked();
+	refresh_watch_lists();
+
+	// Odd means we're in the middle of an update
+	__atomic_store_n(&statusPage->seq, statusPage->seq + 1U, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	statusPage->generation           = watchLists.generation;
+	statusPage->count                = count;
+	statusPage->is_blocker_running   = is_blocker_spawned;
+	statusPage->are_spawns_inhibited = is_spawn_blocked;
+	memcpy(statusPage->watches, watches, count * sizeof(*watches));
+	memset(statusPage->watches + count, 0, (WATCH_MAX - count) * sizeof(*watches));
+
+	// And back to even now that we're done
+	__atomic_store_n(&statusPage->seq, statusPage->seq + 1U, __ATOMIC_RELEASE);
+}
+
+// Handle a connection attempt on socket 'conn_fd', by registering a new IPC session.
 static void
     handle_connection(int conn_fd)
 {
 	// Much like handle_events, we need to ensure fb state is consistent...
-	pthread_mutex_lock(&ptlock);
-	if (unlikely(fbink_reinit(FBFD_AUTO, &fbinkConfig) < 0)) {
-		PFLOG(LOG_WARNING, "fbink_reinit: failure");
-	}
-	pthread_mutex_unlock(&ptlock);
+	fb_reinit();
 
 	int data_fd = -1;
 	// NOTE: The data fd doesn't inherit the connection socket's flags on Linux.
@@ -2801,125 +6416,607 @@ static void
 	if (fdflags == -1) {
 		PFLOG(LOG_WARNING, "getfd fcntl: %m");
 		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
+		close(data_fd);
+		return;
 	}
 	if (fcntl(data_fd, F_SETFD, fdflags | FD_CLOEXEC) == -1) {
 		PFLOG(LOG_WARNING, "setfd fcntl: %m");
 		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
+		close(data_fd);
+		return;
 	}
 	int flflags = fcntl(data_fd, F_GETFL, 0);
 	if (flflags == -1) {
 		PFLOG(LOG_WARNING, "getfl fcntl: %m");
 		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
+		close(data_fd);
+		return;
 	}
 	if (fcntl(data_fd, F_SETFL, flflags | O_NONBLOCK) == -1) {
 		PFLOG(LOG_WARNING, "setfl fcntl: %m");
 		FB_PRINT("[KFMon] fcntl failed ?!");
-		goto cleanup;
+		close(data_fd);
+		return;
+	}
+
+	// Find a free session slot
+	// NOTE: The main loop stops polling the connection socket when we're full, so this should never fail.
+	IpcSession* session = NULL;
+	for (uint8_t i = 0U; i < IPC_SESSIONS_MAX; i++) {
+		if (ipcSessions[i].fd == -1) {
+			session = &ipcSessions[i];
+			break;
+		}
+	}
+	if (!session) {
+		CLOG(LOG_CAT_IPC, LOG_WARNING, "Too many concurrent IPC connections, dropping the new one!");
+		close(data_fd);
+		return;
 	}
+	*session       = (const IpcSession) { 0 };
+	session->fd    = data_fd;
+	session->proto = 1U;
 
 	// We'll want to log some information about the client
 	// c.f., https://github.com/troydhanson/network/tree/master/unixdomain/03.pass-pid
-	struct ucred ucred;
-	socklen_t    len = sizeof(ucred);
-	if (getsockopt(data_fd, SOL_SOCKET, SO_PEERCRED, &ucred, &len) == -1) {
+	socklen_t len = sizeof(session->ucred);
+	if (getsockopt(data_fd, SOL_SOCKET, SO_PEERCRED, &session->ucred, &len) == -1) {
 		PFLOG(LOG_WARNING, "getsockopt: %m");
 		FB_PRINT("[KFMon] getsockopt failed ?!");
-		goto cleanup;
+		close(data_fd);
+		session->fd = -1;
+		return;
 	}
 	// Pull the command name from procfs
 	// NOTE: comm is 16 bytes on Linux
-	char pname[16] = { 0 };
-	get_process_name(ucred.pid, pname);
+	get_process_name(session->ucred.pid, session->pname);
 	// Lookup UID & GID
 	// NOTE: Both fields are 32 bytes on Linux
-	char uname[32] = { 0 };
-	get_user_name(ucred.uid, uname);
-	char gname[32] = { 0 };
-	get_group_name(ucred.gid, gname);
+	get_user_name(session->ucred.uid, session->uname);
+	get_group_name(session->ucred.gid, session->gname);
+
+	kfStats.ipc_connections++;
+
+	// Drop inactive connections after a while
+	clock_gettime(CLOCK_MONOTONIC_RAW, &session->deadline);
+	session->deadline.tv_sec += IPC_IDLE_TIMEOUT;
 
 	// And now we have fancy logging :)
-	LOG(LOG_INFO,
-	    "Handling incoming IPC connection from PID %ld (%s) by user %s:%s",
-	    (long) ucred.pid,
-	    pname,
-	    uname,
-	    gname);
-
-	struct pollfd pfd = { 0 };
-	// Data socket
-	pfd.fd            = data_fd;
-	pfd.events        = POLLIN;
-
-	// Wait for data, for a few 15s windows, in order to drop inactive connections after a while
-	size_t retry = 0U;
-	while (1) {
-		int poll_num = poll(&pfd, 1, 15 * 1000);
-		if (poll_num == -1) {
-			if (errno == EINTR) {
-				continue;
+	CLOG(LOG_CAT_IPC,
+	     LOG_INFO,
+	     "Handling incoming IPC connection from PID %ld (%s) by user %s:%s",
+	     (long) session->ucred.pid,
+	     session->pname,
+	     session->uname,
+	     session->gname);
+}
+
+// Close an IPC session, and release its slot
+static void
+    close_session(IpcSession* session)
+{
+	CLOG(LOG_CAT_IPC,
+	     LOG_INFO,
+	     "Closing IPC connection from PID %ld (%s) by user %s:%s",
+	     (long) session->ucred.pid,
+	     session->pname,
+	     session->uname,
+	     session->gname);
+
+	close(session->fd);
+	free(session->out_buf);
+	free(session->frame_buf);
+	*session    = (const IpcSession) { 0 };
+	session->fd = -1;
+}
+
+// Queue a reply for an IPC session (caller closes the connection on < 0).
+static int
+    queue_reply(IpcSession* session, const char* data, size_t len)
+{
+	// NOTE: Error replies are always sent in one go (and always first)
+	if (strncmp(data, "ERR_", 4) == 0) {
+		kfStats.ipc_errors++;
+	}
+
+	// In framed mode, assemble the full reply first, it'll be sent as a single frame (c.f., handle_framed_command)
+	if (session->is_framing) {
+		if (session->frame_len + len > IPC_OUTBUF_MAX) {
+			CLOG(LOG_CAT_IPC,
+			     LOG_WARNING,
+			     "IPC reply is too large to fit in a frame, dropping the connection!");
+			return -1;
+		}
+		if (session->frame_len + len > session->frame_cap) {
+			size_t cap = MAX(session->frame_cap * 2U, (size_t) PIPE_BUF);
+			while (cap < session->frame_len + len) {
+				cap *= 2U;
+			}
+			cap       = MIN(cap, (size_t) IPC_OUTBUF_MAX);
+			char* buf = realloc(session->frame_buf, cap);
+			if (!buf) {
+				PFLOG(LOG_WARNING, "realloc: %m");
+				return -1;
+			}
+			session->frame_buf = buf;
+			session->frame_cap = cap;
+		}
+		memcpy(session->frame_buf + session->frame_len, data, len);
+		session->frame_len += len;
+		return 0;
+	}
+
+	return queue_output(session, data, len);
+}
+
+// Queue raw data for an IPC session, sending as much as we can right away, without blocking.
+// (caller closes the connection on < 0).
+static int
+    queue_output(IpcSession* session, const char* data, size_t len)
+{
+	// It's already on its way out (c.f., publish_event)
+	if (session->is_dead) {
+		return -1;
+	}
+
+	// Nothing's pending, try to send it straight away
+	if (session->out_len == 0U) {
+		ssize_t sent;
+		do {
+			sent = send(session->fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+		} while (sent == -1 && errno == EINTR);
+		if (sent == -1) {
+			if (errno == EPIPE) {
+				PFLOG(LOG_WARNING, "Client closed the connection early");
+				return -1;
+			} else if (errno != EAGAIN) {
+				PFLOG(LOG_WARNING, "send: %m");
+				FB_PRINT("[KFMon] send failed ?!");
+				return -1;
+			}
+			sent = 0;
+		}
+		data += sent;
+		len -= (size_t) sent;
+		if (len == 0U) {
+			return 0;
+		}
+	}
+
+	// Buffer whatever's left, which will be flushed once the socket is writable again.
+	if (session->out_len + len > IPC_OUTBUF_MAX) {
+		CLOG(LOG_CAT_IPC,
+		     LOG_WARNING,
+		     "IPC client PID %ld (%s) isn't reading its replies (%zu bytes pending), dropping it!",
+		     (long) session->ucred.pid,
+		     session->pname,
+		     session->out_len + len);
+		return -1;
+	}
+	if (session->out_len + len > session->out_cap) {
+		size_t cap = MAX(session->out_cap * 2U, (size_t) PIPE_BUF);
+		while (cap < session->out_len + len) {
+			cap *= 2U;
+		}
+		cap       = MIN(cap, (size_t) IPC_OUTBUF_MAX);
+		char* buf = realloc(session->out_buf, cap);
+		if (!buf) {
+			PFLOG(LOG_WARNING, "realloc: %m");
+			return -1;
+		}
+		session->out_buf = buf;
+		session->out_cap = cap;
+	}
+	// Start the clock on the first pending byte
+	if (session->out_len == 0U) {
+		clock_gettime(CLOCK_MONOTONIC_RAW, &session->write_deadline);
+		session->write_deadline.tv_sec += IPC_WRITE_TIMEOUT;
+	}
+	memcpy(session->out_buf + session->out_len, data, len);
+	session->out_len += len;
+
+	return 0;
+}
+
+// Flush pending replies to an IPC session (caller polled it for POLLOUT)
+static void
+    flush_session_output(IpcSession* session)
+{
+	ssize_t sent;
+	do {
+		sent = send(session->fd, session->out_buf, session->out_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+	} while (sent == -1 && errno == EINTR);
+	if (sent == -1) {
+		if (errno == EAGAIN) {
+			return;
+		}
+		if (errno == EPIPE) {
+			PFLOG(LOG_WARNING, "Client closed the connection early");
+		} else {
+			PFLOG(LOG_WARNING, "send: %m");
+			FB_PRINT("[KFMon] send failed ?!");
+		}
+		close_session(session);
+		return;
+	}
+
+	session->out_len -= (size_t) sent;
+	memmove(session->out_buf, session->out_buf + sent, session->out_len);
+	// It's making progress, push the deadline back
+	if (session->out_len > 0U) {
+		clock_gettime(CLOCK_MONOTONIC_RAW, &session->write_deadline);
+		session->write_deadline.tv_sec += IPC_WRITE_TIMEOUT;
+	}
+}
+
+// Handle input data from an IPC session (caller polled it for POLLIN)
+static void
+    handle_session_input(IpcSession* session)
+{
+	// NOTE: In framed mode, we may have a partial frame left over from the previous read.
+	ssize_t len = read(session->fd,
+			   session->in_buf + session->in_len,
+			   sizeof(session->in_buf) - session->in_len);    // Flawfinder: ignore
+	if (len == -1) {
+		if (errno == EAGAIN || errno == EINTR) {
+			// Spurious wakeup, let the polling trigger a retry
+			return;
+		}
+		PFLOG(LOG_WARNING, "read: %m");
+		FB_PRINT("[KFMon] read failed ?!");
+		// Don't retry, as we risk failing here again otherwise.
+		close_session(session);
+		return;
+	}
+
+	if (len == 0) {
+		// EoF, so whatever's left of a command is all we'll ever get of it: run it before we're done
+		if (session->proto < 2U && session->in_len > 0U && session->wait_pid <= 0) {
+			handle_text_input(session, true);
+		}
+		if (session->fd != -1) {
+			close_session(session);
+		}
+		return;
+	}
+
+	// Push the deadline back, since the client is obviously still alive
+	clock_gettime(CLOCK_MONOTONIC_RAW, &session->deadline);
+	session->deadline.tv_sec += IPC_IDLE_TIMEOUT;
+
+	session->in_len += (size_t) len;
+	if (session->proto >= 2U) {
+		handle_framed_input(session);
+	} else {
+		handle_text_input(session, false);
+	}
+}
+
+// Handle every command buffered in a (v1) IPC session
+// NOTE: Commands are NUL (or LF) terminated, but legacy clients send a single unterminated command per write,
+//       so an unterminated command is only kept around for the rest of it to come in
+//       if it follows a complete one (or some leftovers). At EoF, it's run as-is.
+static void
+    handle_text_input(IpcSession* session, bool is_eof)
+{
+	const char* cmd = session->in_buf;
+	const char* end = session->in_buf + session->in_len;
+	while (cmd < end) {
+		const char* eoc = cmd;
+		while (eoc < end && *eoc != '\0' && *eoc != '\n') {
+			eoc++;
+		}
+
+		// Partial command, wait for the rest of it
+		if (eoc == end && !is_eof && (cmd > session->in_buf || session->has_leftovers)) {
+			session->has_leftovers = true;
+			session->in_len        = (size_t) (end - cmd);
+			if (session->in_len == sizeof(session->in_buf)) {
+				// We'll never see the end of it, give up on that client
+				CLOG(LOG_CAT_IPC,
+				     LOG_WARNING,
+				     "Dropping IPC connection from PID %ld (%s): unterminated command is too long",
+				     (long) session->ucred.pid,
+				     session->pname);
+				kfStats.ipc_dropped++;
+				close_session(session);
+				return;
 			}
-			PFLOG(LOG_WARNING, "poll: %m");
-			FB_PRINT("[KFMon] poll failed ?!");
-			goto early_close;
+			memmove(session->in_buf, cmd, session->in_len);
+			return;
 		}
 
-		if (poll_num > 0) {
-			// Don't even *try* to deal with a connection that was closed by the client,
-			// as we wouldn't be able to reply to it in handle_ipc (NOSIGNAL send on closed socket -> EPIPE),
-			// just close it on our end, too, and move on.
-			// NOTE: Said client should already have reported a timeout waiting for our reply,
-			//       so we don't even try to drain its command, and just forget about it.
-			//       On the upside, that prevents said command from being triggered after a random delay.
-			if (pfd.revents & POLLHUP) {
-				PFLOG(LOG_NOTICE, "Client closed the IPC connection");
-				goto early_close;
+		// Skip empty commands (e.g., a CRLF, or a NUL following a LF)
+		if (eoc > cmd) {
+			struct timespec ipc_ts;
+			trace_mark(&ipc_ts);
+			bool is_done = handle_ipc(session, cmd, (size_t) (eoc - cmd));
+			trace_span("ipc", "ipc", &ipc_ts, -1, 0);
+			if (is_done) {
+				close_session(session);
+				return;
+			}
+
+			// The client switched to framed mode, whatever's left is the start of its first frame(s).
+			if (session->proto >= 2U) {
+				const char* rest = MIN(eoc + 1, end);
+				session->in_len  = (size_t) (end - rest);
+				memmove(session->in_buf, rest, session->in_len);
+				handle_framed_input(session);
+				return;
 			}
 
-			// There's data to be read!
-			if (pfd.revents & POLLIN) {
-				if (handle_ipc(data_fd)) {
-					// We've successfully handled all input data, we're done!
+			// Can't reply to anything else until the process we're waiting on exits, keep the rest for later
+			if (session->wait_pid > 0) {
+				const char* rest       = MIN(eoc + 1, end);
+				session->in_len        = (size_t) (end - rest);
+				session->has_leftovers = session->in_len > 0U;
+				memmove(session->in_buf, rest, session->in_len);
+				return;
+			}
+		}
+
+		cmd = eoc + 1;
+	}
+	session->in_len        = 0U;
+	session->has_leftovers = false;
+}
+
+// Handle every complete frame buffered in a (v2) IPC session
+static void
+    handle_framed_input(IpcSession* session)
+{
+	size_t offset = 0U;
+	while (session->in_len - offset >= sizeof(IpcFrameHeader)) {
+		IpcFrameHeader hdr;
+		memcpy(&hdr, session->in_buf + offset, sizeof(hdr));
+		if (hdr.kind != IPC_FRAME_REQUEST || hdr.len > KFMON_IPC_REQUEST_MAX) {
+			CLOG(LOG_CAT_IPC,
+			     LOG_WARNING,
+			     "Received an invalid IPC frame (kind: %hhu, len: %u) from PID %ld (%s), dropping the connection!",
+			     hdr.kind,
+			     hdr.len,
+			     (long) session->ucred.pid,
+			     session->pname);
+			close_session(session);
+			return;
+		}
+
+		// Wait for the rest of the frame
+		if (session->in_len - offset < sizeof(hdr) + hdr.len) {
+			break;
+		}
+
+		if (handle_framed_command(session, hdr.id, session->in_buf + offset + sizeof(hdr), hdr.len)) {
+			close_session(session);
+			return;
+		}
+		offset += sizeof(hdr) + hdr.len;
+
+		// Requests are processed in order, so we can't go any further until the process we're waiting on exits
+		if (session->wait_pid > 0) {
+			break;
+		}
+	}
+
+	// Keep the leftovers (i.e., a partial frame) for the next read
+	session->in_len -= offset;
+	memmove(session->in_buf, session->in_buf + offset, session->in_len);
+}
+
+// Run a single framed command, and reply with a single frame (caller closes the connection on true).
+static bool
+    handle_framed_command(IpcSession* session, uint32_t id, const char* cmd, size_t len)
+{
+	struct timespec ipc_ts;
+	trace_mark(&ipc_ts);
+	session->frame_len  = 0U;
+	session->req_id     = id;
+	session->is_framing = true;
+	bool is_done        = handle_ipc(session, cmd, len);
+	session->is_framing = false;
+	trace_span("ipc", "ipc", &ipc_ts, -1, 0);
+	if (is_done) {
+		return true;
+	}
+
+	// The reply will only be sent once the process exits (c.f., complete_exit_waits)
+	if (session->wait_pid > 0) {
+		return false;
+	}
+
+	// The final NUL of a v1 reply is redundant with the frame's length
+	size_t payload_len = session->frame_len;
+	if (payload_len > 0U && session->frame_buf[payload_len - 1U] == '\0') {
+		payload_len--;
+	}
+
+	return queue_frame(session, id, IPC_FRAME_REPLY, session->frame_buf, payload_len) < 0;
+}
+
+// Queue a single (v2) frame, its status is inferred from the payload's prefix (caller closes the connection on < 0).
+static int
+    queue_frame(IpcSession* session, uint32_t id, IpcFrameKind kind, const char* payload, size_t len)
+{
+	IpcFrameHeader hdr = { .len = (uint32_t) len, .id = id, .kind = kind };
+	if (len >= 4U && strncmp(payload, "ERR_", 4U) == 0) {
+		hdr.status = IPC_STATUS_ERR;
+	} else if (len >= 5U && strncmp(payload, "WARN_", 5U) == 0) {
+		hdr.status = IPC_STATUS_WARN;
+	} else {
+		hdr.status = IPC_STATUS_OK;
+	}
+
+	if (queue_output(session, (const char*) &hdr, sizeof(hdr)) < 0) {
+		return -1;
+	}
+	if (len > 0U && queue_output(session, payload, len) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+// Reply to the IPC sessions that were waiting on a process that has now exited (c.f., start-wait & trigger-wait)
+static void
+    complete_exit_waits(void)
+{
+	for (uint8_t i = 0U; i < IPC_SESSIONS_MAX; i++) {
+		IpcSession* session = &ipcSessions[i];
+		if (session->fd == -1 || session->wait_pid <= 0) {
+			continue;
+		}
+
+		// Look it up in the spawn history, most recent first
+		SpawnRecord record     = { 0 };
+		bool        is_known   = false;
+		bool        is_running = false;
+		pthread_mutex_lock(&ptlock);
+		for (uint8_t n = 0U; n < SH.count; n++) {
+			const SpawnRecord* restrict entry = &SH.records[(SH.next + HISTORY_MAX - 1U - n) % HISTORY_MAX];
+			if (entry->pid == session->wait_pid) {
+				is_known = true;
+				record   = *entry;
+				break;
+			}
+		}
+		// If it's already been evicted from the history, all we can do is check whether it's still running
+		if (!is_known) {
+			for (uint8_t n = 0U; n < WATCH_MAX; n++) {
+				if (PT.spawn_pids[n] == session->wait_pid) {
+					is_running = true;
 					break;
 				}
 			}
 		}
+		pthread_mutex_unlock(&ptlock);
+		if ((is_known && !record.has_exited) || is_running) {
+			continue;
+		}
 
-		if (poll_num == 0) {
-			// Timed out, increase the retry counter
-			retry++;
+		char buf[128];
+		int  packet_len;
+		if (!is_known) {
+			// We'll never know how it went
+			packet_len = snprintf(buf, sizeof(buf), "ERR_EXIT_UNKNOWN:%ld\n", (long) session->wait_pid);
+		} else if (record.was_lost) {
+			packet_len = snprintf(buf, sizeof(buf), "ERR_REAP_FAILED:%ld\n", (long) record.pid);
+		} else {
+			// Reply with pid:code:runtime_ms, where code is either the exit code or the signal number
+			long long int runtime =
+			    (long long int) (record.end_ts.tv_sec - record.start_ts.tv_sec) * 1000LL +
+			    (record.end_ts.tv_nsec - record.start_ts.tv_nsec) / 1000000L;
+			const char* status = "OK_EXITED";
+			if (record.was_signaled) {
+				status = "WARN_KILLED";
+			} else if (record.status != 0) {
+				status = "WARN_EXITED";
+			}
+			packet_len = snprintf(
+			    buf, sizeof(buf), "%s:%ld:%d:%lld\n", status, (long) record.pid, record.status, runtime);
+		}
+		CLOG(LOG_CAT_SPAWN,
+		     LOG_INFO,
+		     "Process %ld is done, replying to IPC client PID %ld (%s)",
+		     (long) session->wait_pid,
+		     (long) session->ucred.pid,
+		     session->pname);
+
+		// NOTE: This doesn't go through queue_reply, so account for errors ourselves
+		if (strncmp(buf, "ERR_", 4) == 0) {
+			kfStats.ipc_errors++;
+		}
+		int rc;
+		if (session->proto >= 2U) {
+			rc = queue_frame(session, session->wait_id, IPC_FRAME_REPLY, buf, (size_t) packet_len);
+		} else {
+			// w/ NUL
+			rc = queue_output(session, buf, (size_t) (packet_len + 1));
+		}
+		if (rc < 0) {
+			close_session(session);
+			continue;
 		}
+		session->wait_pid = 0;
+		session->wait_id  = 0U;
+
+		// It's been idle through no fault of its own
+		clock_gettime(CLOCK_MONOTONIC_RAW, &session->deadline);
+		session->deadline.tv_sec += IPC_IDLE_TIMEOUT;
 
-		// Drop the axe after 60s.
-		if (retry >= 4) {
-			LOG(LOG_NOTICE, "Dropping inactive IPC connection");
-			goto early_close;
+		// Now that we're caught up, handle whatever it sent us in the meantime
+		if (session->proto >= 2U) {
+			handle_framed_input(session);
+		} else {
+			handle_text_input(session, false);
 		}
 	}
+}
+
+// Drop IPC sessions that have been idle for too long, and return how long (in ms) until the next deadline (-1 if none)
+static int
+    expire_sessions(void)
+{
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
 
-early_close:
-	// We're done, close the data connection
-	LOG(LOG_INFO, "Closing IPC connection from PID %ld (%s) by user %s:%s", (long) ucred.pid, pname, uname, gname);
+	int timeout = -1;
+	for (uint8_t i = 0U; i < IPC_SESSIONS_MAX; i++) {
+		IpcSession* session = &ipcSessions[i];
+		if (session->fd == -1) {
+			continue;
+		}
 
-cleanup:
-	close(data_fd);
+		// We failed to push an event to it
+		if (session->is_dead) {
+			kfStats.ipc_dropped++;
+			close_session(session);
+			continue;
+		}
+
+		// Processes can legitimately run for a long time, don't hold that against clients waiting on one
+		if (session->wait_pid > 0 && session->out_len == 0U) {
+			continue;
+		}
+
+		// If we're waiting on the client to read its replies, that's the only deadline that matters
+		const struct timespec* deadline = session->out_len > 0U ? &session->write_deadline : &session->deadline;
+		long long int          remaining =
+		    (deadline->tv_sec - now.tv_sec) * 1000LL + (deadline->tv_nsec - now.tv_nsec) / 1000000L;
+		if (remaining <= 0) {
+			if (session->out_len > 0U) {
+				CLOG(LOG_CAT_IPC,
+				     LOG_NOTICE,
+				     "Dropping unresponsive IPC connection (%zu bytes left unsent)",
+				     session->out_len);
+			} else {
+				CLOG(LOG_CAT_IPC, LOG_NOTICE, "Dropping inactive IPC connection");
+			}
+			kfStats.ipc_dropped++;
+			close_session(session);
+			continue;
+		}
+
+		if (timeout == -1 || remaining < timeout) {
+			timeout = (int) remaining;
+		}
+	}
+
+	return timeout;
 }
 
 // Handle SQLite logging on error
 static void
     sql_errorlogcb(void* pArg __attribute__((unused)), int iErrCode, const char* zMsg)
 {
+	kfStats.db_errors++;
+	if (!is_log_enabled(LOG_CAT_SQL, LOG_WARNING)) {
+		return;
+	}
 	if (daemonConfig.use_syslog) {
 		syslog(LOG_WARNING, "[*SQL*] %d (%s): %s", iErrCode, sqlite3ErrName(iErrCode), zMsg);
 	} else {
-		fprintf(stderr,
-			"[*SQL*] [%s] [WARN] %d (%s): %s\n",
-			get_current_time(),
-			iErrCode,
-			sqlite3ErrName(iErrCode),
-			zMsg);
+		log_enqueue("*SQL*", LOG_WARNING, "%d (%s): %s", iErrCode, sqlite3ErrName(iErrCode), zMsg);
 	}
 }
 
@@ -2992,6 +7089,9 @@ static bool
 int
     main(int argc __attribute__((unused)), char* argv[] __attribute__((unused)))
 {
+	// Setup our log ring before anything gets logged
+	log_init();
+
 	// Make sure we're running at a neutral niceness
 	// (e.g., being launched via udev would leave us with a negative nice value).
 	if (setpriority(PRIO_PROCESS, 0, 0) == -1) {
@@ -3024,6 +7124,9 @@ int
 	// Squish stderr if we want to log to the syslog...
 	// (can't do that w/ the rest in daemonize, since we don't have our config yet at that point)
 	if (daemonConfig.use_syslog) {
+		// Flush what we've logged so far to our log file first
+		log_flush();
+
 		int fd;
 		// Redirect stderr (which is now actually our log file) to /dev/null
 		if ((fd = open("/dev/null", O_RDWR)) != -1) {
@@ -3038,26 +7141,46 @@ int
 
 		// And connect to the system logger...
 		openlog("kfmon", LOG_CONS | LOG_PID | LOG_NDELAY, LOG_DAEMON);
+	} else {
+		// Otherwise, batch our writes to the log file
+		start_log_thread();
 	}
 
+	// Now that we've got our config, honor its log levels
+	apply_log_levels();
+
 	// Initialize the process table, to track our spawns
 	init_process_table();
 
+	// And start recording them, if requested
+	if (daemonConfig.journal) {
+		journal_open();
+	}
+
 	// Initialize FBInk
 	init_fbink_config();
 	// Consider not being able to print on screen a hard pass...
 	// (Mostly, it's to avoid blowing up later in fbink_print).
-	if (fbink_init(FBFD_AUTO, &fbinkConfig) != EXIT_SUCCESS) {
-		LOG(LOG_ERR, "Failed to initialize FBInk, aborting!");
+	// NOTE: We keep the fb open for our whole lifetime, instead of letting FBInk open & close it on each call.
+	fbHandle.fd = fbink_open();
+	if (fbHandle.fd < 0) {
+		CLOG(LOG_CAT_FBINK, LOG_ERR, "Failed to open the framebuffer, aborting!");
+		exit(EXIT_FAILURE);
+	}
+	if (fbink_init(fbHandle.fd, &fbinkConfig) != EXIT_SUCCESS) {
+		CLOG(LOG_CAT_FBINK, LOG_ERR, "Failed to initialize FBInk, aborting!");
 		exit(EXIT_FAILURE);
 	}
+	atexit(fb_cleanup);
 	// We'll also need the state to handle device detection.
 	// That's the only thing we need it for, which is why we don't refresh it on reinit.
 	fbink_get_state(&fbinkConfig, &fbinkState);
 	// On sunxi, enforce UR for the early boot welcome message.
 	if (fbinkState.is_sunxi) {
-		if (fbink_sunxi_ntx_enforce_rota(FBFD_AUTO, FORCE_ROTA_UR, &fbinkConfig) < 0) {
-			LOG(LOG_WARNING, "Failed to set fbink_sunxi_ntx_enforce_rota to FORCE_ROTA_UR!");
+		if (fbink_sunxi_ntx_enforce_rota(fbHandle.fd, FORCE_ROTA_UR, &fbinkConfig) < 0) {
+			CLOG(LOG_CAT_FBINK,
+			     LOG_WARNING,
+			     "Failed to set fbink_sunxi_ntx_enforce_rota to FORCE_ROTA_UR!");
 		}
 	}
 
@@ -3066,11 +7189,25 @@ int
 		LOG(LOG_ERR, "Failed to setup SQLite, aborting!");
 		exit(EXIT_FAILURE);
 	}
+	// NOTE: Our SQLite build disables memory accounting by default, but we want it for the stats command.
+	//       We only ever do SQL from the main thread, so it's cheap enough.
+	if (sqlite3_config(SQLITE_CONFIG_MEMSTATUS, 1) != SQLITE_OK) {
+		LOG(LOG_WARNING, "Failed to enable SQLite memory accounting!");
+	}
 	if (sqlite3_initialize() != SQLITE_OK) {
 		LOG(LOG_ERR, "Failed to initialize SQLite, aborting!");
 		exit(EXIT_FAILURE);
 	}
 
+	// Seed the watch list generation, so that clients holding one from a previous instance see a change.
+	// NOTE: 0 is reserved, it's what clients send the first time around.
+	struct timespec seed_ts = { 0 };
+	clock_gettime(CLOCK_REALTIME, &seed_ts);
+	watchLists.generation = ((uint32_t) seed_ts.tv_sec ^ ((uint32_t) getpid() << 16U)) | 1U;
+
+	// Setup the status page
+	init_status_page();
+
 	// Setup the IPC socket
 	// NOTE: We want it non-blocking because we handle incoming connections via poll,
 	//       and CLOEXEC not to pollute our spawns.
@@ -3091,14 +7228,31 @@ int
 		exit(EXIT_FAILURE);
 	}
 
-	// NOTE: We only accept a single client, as we can only serve 'em one by one anyway.
+	// NOTE: We serve up to IPC_SESSIONS_MAX clients concurrently, and let a few more wait in the backlog.
 	//       Be aware that, in practice, the kernel will round that up, which means that you can successfully connect,
 	//       send a request, but only get a reply whenever we actually get to it...
-	if (listen(conn_fd, 1) == -1) {
+	for (uint8_t i = 0U; i < IPC_SESSIONS_MAX; i++) {
+		ipcSessions[i].fd = -1;
+	}
+	if (listen(conn_fd, IPC_SESSIONS_MAX) == -1) {
 		PFLOG(LOG_ERR, "Failed to listen to IPC socket (listen: %m), aborting!");
 		exit(EXIT_FAILURE);
 	}
 
+	// Setup the eventfd the reapers use to wake us up when a spawn exits (c.f., dispatch_queued_launches)
+	queue_efd = eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (queue_efd == -1) {
+		PFLOG(LOG_ERR, "Failed to create launch queue eventfd (eventfd: %m), aborting!");
+		exit(EXIT_FAILURE);
+	}
+
+	// Setup the timerfd that drives the spawn watchdog (c.f., handle_watchdog)
+	watchdog_tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (watchdog_tfd == -1) {
+		PFLOG(LOG_ERR, "Failed to create watchdog timerfd (timerfd_create: %m), aborting!");
+		exit(EXIT_FAILURE);
+	}
+
 	// Now that we're properly up, write a pidfile
 	FILE* pid_f = fopen(KFMON_PID_FILE, "we");
 	if (pid_f) {
@@ -3136,18 +7290,22 @@ int
 		// NOTE: The fun new races unearthed by FW 4.31.19086 mean that we usually init *before* the fbdamage
 		//       module has finished its own bringup, making the fbdamage codepaths unusable...
 		if (fbinkState.sunxi_has_fbdamage) {
-			if (fbink_sunxi_ntx_enforce_rota(FBFD_AUTO, FORCE_ROTA_WORKBUF, &fbinkConfig) < 0) {
-				LOG(LOG_NOTICE, "Unable to force FBInk to follow the working buffer's rotation!");
+			if (fbink_sunxi_ntx_enforce_rota(fbHandle.fd, FORCE_ROTA_WORKBUF, &fbinkConfig) < 0) {
+				CLOG(LOG_CAT_FBINK,
+				     LOG_NOTICE,
+				     "Unable to force FBInk to follow the working buffer's rotation!");
 				// Shouldn't really happen, but reset to GYRO just in case...
-				if (fbink_sunxi_ntx_enforce_rota(FBFD_AUTO, FORCE_ROTA_GYRO, &fbinkConfig) < 0) {
+				if (fbink_sunxi_ntx_enforce_rota(fbHandle.fd, FORCE_ROTA_GYRO, &fbinkConfig) < 0) {
 					LOG(LOG_WARNING,
 					    "Failed to reset fbink_sunxi_ntx_enforce_rota to FORCE_ROTA_GYRO!");
 				}
 			}
 		} else {
 			LOG(LOG_NOTICE, "FBDamage is not available");
-			if (fbink_sunxi_ntx_enforce_rota(FBFD_AUTO, FORCE_ROTA_GYRO, &fbinkConfig) < 0) {
-				LOG(LOG_WARNING, "Failed to reset fbink_sunxi_ntx_enforce_rota to FORCE_ROTA_GYRO!");
+			if (fbink_sunxi_ntx_enforce_rota(fbHandle.fd, FORCE_ROTA_GYRO, &fbinkConfig) < 0) {
+				CLOG(LOG_CAT_FBINK,
+				     LOG_WARNING,
+				     "Failed to reset fbink_sunxi_ntx_enforce_rota to FORCE_ROTA_GYRO!");
 			}
 		}
 
@@ -3173,11 +7331,7 @@ int
 
 		// Here, on subsequent iterations, we might be printing stuff *before* handle_events or handle_connection,
 		// (mainly in error-ish codepaths), so we need to check the fb state right now, too...
-		pthread_mutex_lock(&ptlock);
-		if (unlikely(fbink_reinit(FBFD_AUTO, &fbinkConfig) < 0)) {
-			PFLOG(LOG_WARNING, "fbink_reinit: failure");
-		}
-		pthread_mutex_unlock(&ptlock);
+		fb_reinit();
 
 		// Make sure our target partition is mounted
 		if (!is_target_mounted()) {
@@ -3186,6 +7340,14 @@ int
 			wait_for_target_mountpoint();
 		}
 
+		// Whatever watch changes we pick up below are one burst of notifications (c.f., fb_begin_batch)
+		fb_begin_batch();
+
+		// If we started from our config snapshot, now's the time to check it against the actual config files
+		if (isConfigProvisional) {
+			revalidate_config();
+		}
+
 		// Reload *watch* configs to see if we have something new to pickup after an USBMS session
 		// NOTE: Mainly up there for clarity, otherwise it technically belongs at the end of the loop.
 		//       The only minor drawback of having it up there is that it'll run on startup.
@@ -3195,6 +7357,7 @@ int
 			FB_PRINT("[KFMon] Failed to update watch configs!");
 			exit(EXIT_FAILURE);
 		}
+		fb_end_batch();
 
 		// Create the file descriptor for accessing the inotify API
 		LOG(LOG_INFO, "Initializing inotify.");
@@ -3228,71 +7391,82 @@ int
 				continue;
 			}
 
-			watchConfig[watch_idx].inotify_wd =
-			    inotify_add_watch(fd, watchConfig[watch_idx].filename, IN_OPEN | IN_CLOSE);
-			if (watchConfig[watch_idx].inotify_wd == -1) {
-				// NOTE: Allow running without an actual inotify watch, keeping the action IPC only...
-				//       We could limit this behavior to !hidden watches, or hide it behind another config flag,
-				//       but it's harmless enough to do it unconditionally ;).
-				//       The watch will be released properly if the *config* file gets removed.
-				if (errno == ENOENT) {
-					// Only account for ENOENT, though ;) (i.e., filename is gone).
-					LOG(LOG_NOTICE,
-					    "Setup an IPC-only watch for '%s' @ index %hhu.",
-					    basename(watchConfig[watch_idx].filename),
-					    watch_idx);
-				} else {
-					PFLOG(LOG_WARNING, "inotify_add_watch: %m");
-					LOG(LOG_WARNING,
-					    "Cannot watch '%s', discarding it!",
-					    watchConfig[watch_idx].filename);
-					FB_PRINTF("[KFMon] Failed to watch %s!",
-						  basename(watchConfig[watch_idx].filename));
-					// NOTE: We used to abort entirely in case even one target file couldn't be watched,
-					//       but that was a bit harsh ;).
-					//       Since the inotify watch couldn't be setup,
-					//       there's no way for this to cause trouble down the road,
-					//       and this allows the user to fix it during an USBMS session,
-					//       instead of having to reboot.
-
-					// If that watch isn't currently running, clear it entirely!
-					pthread_mutex_lock(&ptlock);
-					bool is_watch_spawned = is_watch_already_spawned(watch_idx);
-					pthread_mutex_unlock(&ptlock);
-					if (is_watch_spawned) {
-						LOG(LOG_WARNING,
-						    "Cannot release watch slot %hhu (%s => %s), as it's currently running!",
-						    watch_idx,
-						    basename(watchConfig[watch_idx].filename),
-						    basename(watchConfig[watch_idx].action));
-					} else {
-						watchConfig[watch_idx] = (const WatchConfig) { 0 };
-						// NOTE: This should essentially come down to:
-						//memset(&watchConfig[watch_idx], 0, sizeof(WatchConfig));
-						LOG(LOG_NOTICE, "Released watch slot %hhu.", watch_idx);
-					}
-				}
-			} else {
-				LOG(LOG_NOTICE,
-				    "Setup an inotify watch for '%s' @ index %hhu.",
-				    watchConfig[watch_idx].filename,
-				    watch_idx);
-			}
+			add_target_watch(fd, watch_idx);
+		}
+
+		// And keep an eye on our config directory, so that config changes can be applied on the fly.
+		// NOTE: IN_MOVED_* because editors & file managers tend to write to a temporary file and rename it,
+		//       and renaming a config away is the same as deleting it as far as we're concerned.
+		configDirWd = inotify_add_watch(
+		    fd, KFMON_CONFIGPATH, IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_ONLYDIR);
+		if (configDirWd == -1) {
+			PFLOG(LOG_WARNING, "inotify_add_watch: %m");
+			LOG(LOG_WARNING, "Cannot watch the config directory, config changes will only be picked up on remount!");
+		} else {
+			LOG(LOG_NOTICE, "Setup an inotify watch for config directory '%s'.", KFMON_CONFIGPATH);
 		}
 
-		struct pollfd pfds[2] = { 0 };
-		nfds_t        nfds    = 2;
+		// Now that our watches are all setup, let the world know
+		update_status_page();
+
+		// NOTE: The first few are fixed, the rest are our IPC sessions
+#define PFDS_FIXED 4
+		struct pollfd pfds[PFDS_FIXED + IPC_SESSIONS_MAX] = { 0 };
+		IpcSession*   pfd_sessions[IPC_SESSIONS_MAX]      = { 0 };
 		// Inotify input
-		pfds[0].fd            = fd;
-		pfds[0].events        = POLLIN;
+		pfds[0].fd                                        = fd;
+		pfds[0].events                                    = POLLIN;
 		// Connection socket
-		pfds[1].fd            = conn_fd;
-		pfds[1].events        = POLLIN;
+		pfds[1].fd                                        = conn_fd;
+		// Spawn exits
+		pfds[2].fd                                        = queue_efd;
+		pfds[2].events                                    = POLLIN;
+		// Watchdog ticks
+		pfds[3].fd                                        = watchdog_tfd;
+		pfds[3].events                                    = POLLIN;
 
 		// Wait for events
 		LOG(LOG_INFO, "Listening for events.");
 		while (1) {
-			int poll_num = poll(pfds, nfds, -1);
+			// Drop idle IPC sessions, and compute how long we can sleep for
+			int timeout      = expire_sessions();
+			// Ditto for the watches of config files that are gone
+			int gone_timeout = drop_gone_configs(fd);
+			if (gone_timeout != -1 && (timeout == -1 || gone_timeout < timeout)) {
+				timeout = gone_timeout;
+			}
+			// NOTE: As long as something is queued, make sure we're up in time for the next retry,
+			//       so that expired requests get dropped, and the BLOCK file going away is honored.
+			if (LQ.count > 0U) {
+				struct timespec now = { 0 };
+				clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+				long long int remaining = (LQ.retry_ts.tv_sec - now.tv_sec) * 1000LL +
+							  (LQ.retry_ts.tv_nsec - now.tv_nsec) / 1000000L;
+				remaining = MAX(remaining, 0LL);
+				if (timeout == -1 || remaining < timeout) {
+					timeout = (int) remaining;
+				}
+			}
+
+			// Rebuild the session part of the poll set
+			nfds_t nfds = PFDS_FIXED;
+			for (uint8_t i = 0U; i < IPC_SESSIONS_MAX; i++) {
+				if (ipcSessions[i].fd == -1) {
+					continue;
+				}
+				pfd_sessions[nfds - PFDS_FIXED] = &ipcSessions[i];
+				pfds[nfds].fd                   = ipcSessions[i].fd;
+				// NOTE: Don't read any new commands until the client has read its pending replies,
+				//       or while it's waiting on a process to exit (we'll still notice hang-ups).
+				pfds[nfds].events =
+				    ipcSessions[i].out_len > 0U ? POLLOUT : (ipcSessions[i].wait_pid > 0 ? 0 : POLLIN);
+				pfds[nfds].revents              = 0;
+				nfds++;
+			}
+			// Stop accepting new connections while we're full (they'll wait in the backlog)
+			pfds[1].events = (nfds < PFDS_FIXED + IPC_SESSIONS_MAX) ? POLLIN : 0;
+
+			int poll_num = poll(pfds, nfds, timeout);
 			if (poll_num == -1) {
 				if (errno == EINTR) {
 					continue;
@@ -3310,14 +7484,76 @@ int
 						// destroyed automatically after an unmount or an unlink, for instance)
 						break;
 					}
+					// Our state may have changed (if nothing else, we may have noticed the BLOCK file)
+					update_status_page();
 				}
 
 				if (pfds[1].revents & POLLIN) {
 					// There was a new connection attempt
 					handle_connection(conn_fd);
 				}
+
+				if (pfds[2].revents & POLLIN) {
+					// A spawn exited, drain the counter, and see if we can launch something from the queue
+					eventfd_t exits;
+					eventfd_read(queue_efd, &exits);
+					publish_exit_events();
+					complete_exit_waits();
+					dispatch_queued_launches();
+					update_status_page();
+				}
+
+				if (pfds[3].revents & POLLIN) {
+					// Check up on our spawns
+					handle_watchdog();
+				}
+
+				for (nfds_t n = PFDS_FIXED; n < nfds; n++) {
+					IpcSession* session = pfd_sessions[n - PFDS_FIXED];
+					// It may have been closed in the meantime (e.g., by complete_exit_waits)
+					if (session->fd != pfds[n].fd) {
+						continue;
+					}
+					// Don't even *try* to deal with a connection that was closed by the client,
+					// as we wouldn't be able to reply to it in handle_ipc (NOSIGNAL send on closed socket -> EPIPE),
+					// just close it on our end, too, and move on.
+					// NOTE: Said client should already have reported a timeout waiting for our reply,
+					//       so we don't even try to drain its command, and just forget about it.
+					//       On the upside, that prevents said command from being triggered after a random delay.
+					if (pfds[n].revents & (POLLHUP | POLLERR | POLLNVAL)) {
+						CLOG(LOG_CAT_IPC,
+						     LOG_NOTICE,
+						     "[%s] Client closed the IPC connection",
+						     __PRETTY_FUNCTION__);
+						close_session(session);
+						continue;
+					}
+
+					// Our pending replies can go through
+					if (pfds[n].revents & POLLOUT) {
+						flush_session_output(session);
+					}
+
+					// There's data to be read!
+					if (pfds[n].revents & POLLIN) {
+						handle_session_input(session);
+					}
+				}
+			}
+
+			// Retry the queue on schedule, no matter how busy we are
+			// (i.e., steady IPC traffic may very well never let poll time out).
+			if (LQ.count > 0U) {
+				struct timespec now = { 0 };
+				clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+				if (now.tv_sec > LQ.retry_ts.tv_sec ||
+				    (now.tv_sec == LQ.retry_ts.tv_sec && now.tv_nsec >= LQ.retry_ts.tv_nsec)) {
+					dispatch_queued_launches();
+					schedule_queue_retry();
+				}
 			}
 		}
+#undef PFDS_FIXED
 		LOG(LOG_INFO, "Stopped listening for events.");
 
 		// Close inotify file descriptor
@@ -3326,6 +7562,8 @@ int
 
 	// Close the IPC connection socket. Unreachable.
 	close(conn_fd);
+	close(queue_efd);
+	close(watchdog_tfd);
 	unlink(KFMON_IPC_SOCKET);
 	// Release SQLite resources. Also unreachable ;p.
 	sqlite3_shutdown();
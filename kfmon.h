@@ -29,6 +29,9 @@
 #include "inih/ini.h"
 #include "openssh/atomicio.h"
 #include "str5/str5.h"
+#include "utils/ipc_proto.h"
+#include "utils/journal_format.h"
+#include "utils/status_page.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <fts.h>
@@ -41,16 +44,23 @@
 #include <pwd.h>
 #include <signal.h>
 #include <sqlite3.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <dirent.h>
+#include <spawn.h>
+#include <sys/eventfd.h>
 #include <sys/inotify.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
+#include <sys/timerfd.h>
 #include <sys/types.h>
 #include <sys/un.h>
 #include <sys/wait.h>
@@ -86,6 +96,41 @@ extern const char* sqlite3ErrName(int);
 #	define KFMON_CONFIGPATH "/home/niluje/Kindle/Staging/kfmon"
 #endif
 
+// Path to our launch trace (c.f., trace_enable)
+#ifndef NILUJE
+#	define KFMON_TRACEFILE "/usr/local/kfmon/kfmon-trace.json"
+#else
+#	define KFMON_TRACEFILE "/home/niluje/Kindle/Staging/kfmon-trace.json"
+#endif
+
+// Path to our event journal (c.f., journal_open)
+#ifndef NILUJE
+#	define KFMON_JOURNAL "/usr/local/kfmon/kfmon-journal.bin"
+#else
+#	define KFMON_JOURNAL "/home/niluje/Kindle/Staging/kfmon-journal.bin"
+#endif
+
+// Path to our metrics dump (c.f., stats_dump)
+#ifndef NILUJE
+#	define KFMON_STATSFILE "/usr/local/kfmon/kfmon-stats.prom"
+#else
+#	define KFMON_STATSFILE "/home/niluje/Kindle/Staging/kfmon-stats.prom"
+#endif
+
+// Path to our config snapshot (c.f., save_config_snapshot)
+#ifndef NILUJE
+#	define KFMON_CONFIG_SNAPSHOT "/usr/local/kfmon/kfmon-config.snap"
+#else
+#	define KFMON_CONFIG_SNAPSHOT "/home/niluje/Kindle/Staging/kfmon-config.snap"
+#endif
+
+// Where our in-memory log is dumped to (c.f., log_save_ram)
+#ifndef NILUJE
+#	define KFMON_LOG_RAMDUMP KFMON_TARGET_MOUNTPOINT "/.adds/kfmon/log/kfmon_ram.log"
+#else
+#	define KFMON_LOG_RAMDUMP "/home/niluje/Kindle/Staging/kfmon_ram.log"
+#endif
+
 // Path to our pidfile
 #define KFMON_PID_FILE "/var/run/kfmon.pid"
 
@@ -136,33 +181,37 @@ char (&ARRAY_SIZE_HELPER(T (&array)[N]))[N];
 #endif
 
 // NOTE: See https://kernelnewbies.org/FAQ/DoWhile0 for the reasoning behind the use of GCC's ({ … }) notation
-// Log everything to stderr (which actually points to our logfile)
-#define LOG(prio, fmt, ...)                                                                                              \
+// Log everything to stderr (which actually points to our logfile), by way of our log ring (c.f., log_thread)
+// NOTE: Unfiltered, you probably want LOG or CLOG instead.
+#define RAWLOG(prio, fmt, ...)                                                                                           \
 	({                                                                                                               \
 		if (daemonConfig.use_syslog) {                                                                           \
 			syslog(prio, fmt, ##__VA_ARGS__);                                                                \
 		} else {                                                                                                 \
-			fprintf(stderr,                                                                                  \
-				"[KFMon] [%s] [%s] " fmt "\n",                                                           \
-				get_current_time(),                                                                      \
-				get_log_prefix(prio),                                                                    \
-				##__VA_ARGS__);                                                                          \
+			log_enqueue("KFMon", prio, fmt, ##__VA_ARGS__);                                                  \
 		}                                                                                                        \
 	})
 
-// Same, but with __PRETTY_FUNCTION__ right before fmt
-#define PFLOG(prio, fmt, ...) ({ LOG(prio, "[%s] " fmt, __PRETTY_FUNCTION__, ##__VA_ARGS__); })
-
-// Slight variation without date/time handling to ensure thread safety
-#define MTLOG(prio, fmt, ...)                                                                                            \
+// Same, but only if the log level of the category cat (c.f., LogCategory) lets it through.
+// NOTE: That's checked before anything gets formatted, so filtered out messages are nearly free.
+#define CLOG(cat, prio, fmt, ...)                                                                                        \
 	({                                                                                                               \
-		if (daemonConfig.use_syslog) {                                                                           \
-			syslog(prio, fmt, ##__VA_ARGS__);                                                                \
-		} else {                                                                                                 \
-			fprintf(stderr, "[KFMon] " fmt "\n", ##__VA_ARGS__);                                             \
+		if (is_log_enabled(cat, prio)) {                                                                         \
+			RAWLOG(prio, fmt, ##__VA_ARGS__);                                                                \
 		}                                                                                                        \
 	})
 
+// Uncategorized messages
+#define LOG(prio, fmt, ...) ({ CLOG(LOG_CAT_GENERAL, prio, fmt, ##__VA_ARGS__); })
+
+// Same, but with __PRETTY_FUNCTION__ right before fmt
+#define PFLOG(prio, fmt, ...) ({ LOG(prio, "[%s] " fmt, __PRETTY_FUNCTION__, ##__VA_ARGS__); })
+
+// What we use from our other threads.
+// NOTE: This used to skip the date/time handling to ensure thread safety,
+//       but the log ring takes care of that now, so it's just an alias.
+#define MTLOG(prio, fmt, ...) ({ LOG(prio, fmt, ##__VA_ARGS__); })
+
 // Same, but with __PRETTY_FUNCTION__ right before fmt
 #define PFMTLOG(prio, fmt, ...) ({ MTLOG(prio, "[%s] " fmt, __PRETTY_FUNCTION__, ##__VA_ARGS__); })
 
@@ -179,6 +228,33 @@ char (&ARRAY_SIZE_HELPER(T (&array)[N]))[N];
 		}                                                                                                        \
 	})
 
+// Log categories, each with their own log level (c.f., the log_level keys & the log-level IPC command)
+typedef enum
+{
+	LOG_CAT_GENERAL = 0U,
+	LOG_CAT_EVENTS,
+	LOG_CAT_SQL,
+	LOG_CAT_THUMBNAILS,
+	LOG_CAT_SPAWN,
+	LOG_CAT_IPC,
+	LOG_CAT_FBINK,
+	LOG_CAT_CONFIG,
+	LOG_CAT_MAX
+} LogCategory;
+#define LOG_CATEGORIES { "general", "events", "sql", "thumbnails", "spawn", "ipc", "fbink", "config" }
+// Everything goes by default, including the DBGLOG extras in DEBUG builds
+#define LOG_LEVEL_DEFAULT (DEBUG_LOG ? LOG_DEBUG : LOG_INFO)
+// Current log level of each category (i.e., the lowest priority that gets through)
+// NOTE: Set from our config (c.f., apply_log_levels), but can be tweaked at runtime over IPC.
+//       Read from every thread, hence the atomics.
+uint8_t            logLevels[LOG_CAT_MAX] = { [0 ... LOG_CAT_MAX - 1] = LOG_LEVEL_DEFAULT };
+#define is_log_enabled(cat, prio) ((prio) <= __atomic_load_n(&logLevels[cat], __ATOMIC_RELAXED))
+static int         parse_log_level(const char*, uint8_t*);
+static const char* log_level_to_str(uint8_t) __attribute__((const));
+static int         parse_log_category(const char*);
+static void        apply_log_levels(void);
+static int         format_log_levels(char*, size_t, const char*);
+
 // Likely/Unlikely branch tagging
 #define likely(x)   __builtin_expect(!!(x), 1)
 #define unlikely(x) __builtin_expect(!!(x), 0)
@@ -210,7 +286,16 @@ char (&ARRAY_SIZE_HELPER(T (&array)[N]))[N];
 typedef struct
 {
 	unsigned short int db_timeout;
+	unsigned short int queue_ttl;
+	unsigned short int log_flush;
+	unsigned short int log_segment_size;
+	unsigned short int log_segments;
+	bool               log_compress;
+	bool               log_to_ram;
 	bool               use_syslog;
+	bool               journal;
+	// Log level of each category, + 1 (i.e., 0 means default, c.f., apply_log_levels)
+	uint8_t            log_levels[LOG_CAT_MAX];
 	bool               with_notifications;
 	bool               with_storage_notifications;
 } DaemonConfig;
@@ -218,21 +303,24 @@ typedef struct
 // What a watch config should look like
 typedef struct
 {
-	time_t processing_ts;
-	int    inotify_wd;
-	char   filename[CFG_SZ_MAX];
-	char   action[CFG_SZ_MAX];
-	char   label[CFG_SZ_MAX];
-	char   db_title[DB_SZ_MAX];
-	char   db_author[DB_SZ_MAX];
-	char   db_comment[DB_SZ_MAX];
-	bool   hidden;
-	bool   skip_db_checks;
-	bool   do_db_update;
-	bool   block_spawns;
-	bool   wd_was_destroyed;
-	bool   pending_processing;
-	bool   is_active;
+	time_t             processing_ts;
+	int                inotify_wd;
+	char               filename[CFG_SZ_MAX];
+	char               action[CFG_SZ_MAX];
+	char               label[CFG_SZ_MAX];
+	char               db_title[DB_SZ_MAX];
+	char               db_author[DB_SZ_MAX];
+	char               db_comment[DB_SZ_MAX];
+	// Watchdog policies, in seconds (0 means disabled)
+	unsigned short int max_runtime;
+	unsigned short int max_idle;
+	bool               hidden;
+	bool               skip_db_checks;
+	bool               do_db_update;
+	bool               block_spawns;
+	bool               wd_was_destroyed;
+	bool               pending_processing;
+	bool               is_active;
 } WatchConfig;
 
 // Used for thumbnail munging shenanigans
@@ -267,6 +355,116 @@ static int8_t   get_next_available_pt_entry(void);
 static void     add_process_to_table(uint8_t, pid_t, uint8_t);
 static void     remove_process_from_table(uint8_t);
 
+// Keep an eye on spawns from watches with a max_runtime and/or max_idle policy, indexed like the process table.
+// When a policy is violated, the spawn's whole process group gets a SIGTERM, followed by a SIGKILL WATCHDOG_GRACE seconds later.
+// NOTE: Only ever accessed from the main thread, which is woken up every second by watchdog_tfd while there's something to watch.
+#define WATCHDOG_GRACE 5
+typedef struct
+{
+	struct timespec    start_ts;
+	// Last time the process group was seen using some CPU time
+	struct timespec    active_ts;
+	// When we sent the SIGTERM
+	struct timespec    term_ts;
+	unsigned long long cpu_ticks;
+	// Start time (in clock ticks since boot) of the youngest member of the process group when we sent the SIGTERM
+	unsigned long long term_start;
+	// -1 means the entry is available
+	pid_t              pgid;
+	uint8_t            watch_idx;
+	bool               is_terminating;
+} WatchdogEntry;
+WatchdogEntry WD[WATCH_MAX];
+int           watchdog_tfd   = -1;
+bool          watchdog_armed = false;
+
+// What /proc has to say about a process group (c.f., scan_pgrps)
+typedef struct
+{
+	pid_t              pgid;
+	unsigned int       members;
+	// CPU time used by its members, including their reaped children (in clock ticks)
+	unsigned long long cpu_ticks;
+	// Start time of its oldest member (in clock ticks since boot)
+	unsigned long long oldest_start;
+	// Ditto for its youngest member
+	unsigned long long newest_start;
+} PgrpInfo;
+static void watchdog_track(uint8_t, pid_t, uint8_t);
+static void watchdog_set_timer(bool);
+static void scan_pgrps(PgrpInfo*, uint8_t);
+static void watchdog_finish(const WatchdogEntry*);
+static void handle_watchdog(void);
+
+// Where a spawn request came from
+typedef enum
+{
+	SPAWN_FROM_INOTIFY = 0U,
+	SPAWN_FROM_IPC,
+} SpawnSource;
+
+// Keep track of our last few spawns (and how they turned out), so that it can be queried over IPC.
+// NOTE: Protected by ptlock, since it's updated by the reaper threads, too.
+#define HISTORY_MAX 32
+typedef struct
+{
+	struct timespec start_ts;
+	struct timespec end_ts;
+	pid_t           pid;
+	// Exit code, or signal number if was_signaled
+	int             status;
+	int8_t          watch_idx;
+	uint8_t         source;
+	bool            has_exited;
+	bool            was_signaled;
+	// We failed to reap it, so we don't know how it went (status is -1)
+	bool            was_lost;
+	// Whether the exit was pushed to IPC subscribers yet (c.f., publish_exit_events)
+	bool            was_published;
+	char            name[CFG_SZ_MAX];
+} SpawnRecord;
+struct spawn_history
+{
+	SpawnRecord records[HISTORY_MAX];
+	// Index of the slot the next spawn will be recorded in
+	uint8_t     next;
+	uint8_t     count;
+} SH;
+static void        record_spawn(pid_t, uint8_t, SpawnSource);
+static void        record_exit(pid_t, int, bool);
+static const char* exit_state_to_str(const SpawnRecord*) __attribute__((pure));
+static const char* spawn_source_to_str(uint8_t) __attribute__((const));
+
+// Launch requests that couldn't be honored right away can be queued, and will be retried as soon as a spawn exits.
+// NOTE: Only ever accessed from the main thread, the reapers simply poke queue_efd to wake it up.
+#define QUEUE_MAX         8
+// Fallback TTL (in seconds) for IPC queue requests when neither the request nor kfmon.ini specify one
+#define QUEUE_TTL_DEFAULT 30
+// How often (in ms) the queue is retried on our own, regardless of exits (for expiry, and the BLOCK file going away)
+#define QUEUE_RETRY_MS    1000
+typedef struct
+{
+	struct timespec deadline;
+	uint8_t         watch_idx;
+	uint8_t         source;
+	// Used to make sure the watch slot wasn't recycled in the meantime
+	char            name[CFG_SZ_MAX];
+} QueuedLaunch;
+struct launch_queue
+{
+	// FIFO, oldest first
+	QueuedLaunch    entries[QUEUE_MAX];
+	// When we're due for our next retry (c.f., QUEUE_RETRY_MS)
+	struct timespec retry_ts;
+	uint8_t         count;
+} LQ;
+int         queue_efd = -1;
+static int  queue_launch(uint8_t, SpawnSource, unsigned short int);
+static void schedule_queue_retry(void);
+static void remove_queued_launch(uint8_t);
+static void drop_queued_launch(uint8_t);
+static void dispatch_queued_launches(void);
+
 static void init_fbink_config(void);
 
 // SQLite macros inspired from http://www.lemoda.net/c/sqlite-insert/ :)
@@ -286,12 +484,215 @@ int        origStdout;
 int        origStderr;
 static int daemonize(void);
 
-static struct tm*  get_localtime(struct tm* restrict);
+// Formatting timestamps is expensive-ish (tzset, localtime_r & strftime), so only do it once per second.
+typedef struct
+{
+	time_t t;
+	char   sz_time[22];
+} TimeStampCache;
+static struct tm*  get_localtime(time_t, struct tm* restrict);
 static char*       format_localtime(struct tm* restrict, char* restrict, size_t);
-static char*       get_current_time(void);
-static char*       get_current_time_r(struct tm* restrict, char* restrict, size_t);
+static const char* format_timestamp(TimeStampCache* restrict, time_t);
 static const char* get_log_prefix(int) __attribute__((const));
 
+// Our log lines are formatted straight into a lock-free ring (multiple producers: the main thread & the reapers),
+// and a dedicated thread (c.f., log_thread) batches them to disk every daemonConfig.log_flush ms,
+// so that logging never has to hit the disk on the hot path.
+// NOTE: Slots use the sequence number scheme from Dmitry Vyukov's bounded MPMC queue
+//       (c.f., https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue),
+//       with a single consumer, which is serialized by loglock.
+#define LOG_RING_SLOTS 128U    // Must be a power of two
+#define LOG_LINE_MAX   1024U
+// Batch size of our writes
+#define LOG_FLUSH_SZ   (16U * 1024U)
+// Our log is rotated into that many segments (c.f., log_rotate) of that size (in KB), unless kfmon.ini says otherwise
+#define LOG_SEGMENTS_DEFAULT     4U
+#define LOG_SEGMENT_SIZE_DEFAULT 256U
+// Keep segment suffixes to a single digit
+#define LOG_SEGMENTS_MAX         9U
+typedef struct
+{
+	uint32_t    seq;
+	int         prio;
+	time_t      ts;
+	const char* tag;
+	size_t      len;
+	char        msg[LOG_LINE_MAX];
+} LogSlot;
+typedef struct
+{
+	LogSlot  slots[LOG_RING_SLOTS];
+	// Next slot to claim (producers)
+	uint32_t head;
+	// Next slot to drain (consumer)
+	uint32_t tail;
+	// Lines we had to drop because the ring was full
+	uint32_t dropped;
+	// Wakes the logger thread up
+	int      efd;
+	// Set when we're asked to quit (c.f., log_term_handler)
+	int      term_sig;
+	// Our background gzip job, if any (c.f., log_rotate)
+	pid_t    gzip_pid;
+	// Until the logger thread is up, producers flush their own lines
+	bool     is_running;
+} LogRing;
+LogRing         logRing = { .efd = -1 };
+pthread_mutex_t loglock = PTHREAD_MUTEX_INITIALIZER;
+// Identical consecutive lines are collapsed into a "last message repeated N times" one (à la syslogd),
+// as long as they keep coming within LOG_REPEAT_WINDOW seconds of the first one.
+// NOTE: Only ever touched by log_flush, so, protected by loglock.
+#define LOG_REPEAT_WINDOW 30
+typedef struct
+{
+	time_t       first_ts;
+	time_t       last_ts;
+	const char*  tag;
+	size_t       len;
+	int          prio;
+	// How many repeats we've swallowed so far
+	unsigned int count;
+	char         msg[LOG_LINE_MAX];
+} LogRepeat;
+LogRepeat     logRepeat = { 0 };
+static size_t log_format_repeats(char*, size_t, TimeStampCache*);
+static void   log_final_flush(void);
+// With log_to_ram, the log never hits the disk: it's kept in that text ring instead,
+// which can be queried over IPC (c.f., log-dump), and is saved to the userstore on demand (c.f., log-save) or on crash.
+// NOTE: Anything written to stderr (e.g., by FBInk) is captured in there, too (c.f., capture_stderr).
+#define LOG_RAM_SZ      (128U * 1024U)
+// Keep log-dump replies small enough to fit in a single v2 frame
+#define LOG_DUMP_SZ_MAX (IPC_OUTBUF_MAX / 2)
+typedef struct
+{
+	char   data[LOG_RAM_SZ];
+	// Total amount of bytes ever written, the ring holds the last LOG_RAM_SZ of those
+	size_t head;
+	// Read end of our stderr capture
+	int    pipe_fd;
+} RamLog;
+RamLog          ramLog = { .pipe_fd = -1 };
+static void     log_init(void);
+static void     log_enqueue(const char* restrict, int, const char* restrict, ...)
+    __attribute__((format(printf, 3, 4)));
+static void     log_wakeup(void);
+static void     log_flush(void);
+static bool     log_wait(int);
+static void*    log_thread(void*);
+static void     log_term_handler(int);
+static void     start_log_thread(void);
+static void     reap_log_compressor(bool);
+static void     log_write(const char*, size_t);
+static void     ramlog_append(const char*, size_t);
+static size_t   ramlog_tail(char*, size_t, unsigned int);
+static int      log_save_ram(const char*);
+static void     capture_stderr(void);
+static void     drain_stderr_capture(void);
+static void     log_crash_handler(int);
+static void     log_rotate(void);
+static void     log_rotate_if_needed(void);
+
+// Keep track of the launch trace, which we write in Chrome's Trace Event Format (JSON Array flavor),
+// so that it can be loaded as-is in chrome://tracing or https://ui.perfetto.dev
+// c.f., https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+// NOTE: Once the file grows past TRACE_SZ_MAX, we simply start over from scratch.
+#define TRACE_SZ_MAX (512 * 1024)
+typedef struct
+{
+	size_t size;
+	int    fd;
+	// NOTE: Checked without tracelock on the fast path (c.f., trace_mark), so, only ever set via __atomic builtins.
+	bool   enabled;
+} LaunchTrace;
+LaunchTrace     launchTrace = { .fd = -1 };
+// NOTE: Spans can be recorded from the reaper threads, too.
+pthread_mutex_t tracelock   = PTHREAD_MUTEX_INITIALIZER;
+static int      trace_enable(void);
+static void     trace_disable(void);
+static void     trace_mark(struct timespec* restrict);
+static void     trace_span(const char* restrict, const char* restrict, const struct timespec* restrict, int8_t, pid_t);
+
+// Keep a binary journal of launch events (c.f., utils/journal_format.h), which can be decoded with kfmon-journal.
+// Records are batched, and written out by the logger thread, or as soon as the batch is full.
+// NOTE: Once the file grows past JOURNAL_SZ_MAX (i.e., ~32K records), it's moved to KFMON_JOURNAL ".old",
+//       and we start a new one.
+#define JOURNAL_BATCH  16U
+#define JOURNAL_SZ_MAX (1024 * 1024)
+typedef struct
+{
+	JournalRecord records[JOURNAL_BATCH];
+	// The watch names we've already recorded in the current file (c.f., JOURNAL_EV_WATCH)
+	char          names[WATCH_MAX][JOURNAL_NAME_SZ];
+	size_t        size;
+	uint8_t       count;
+	// NOTE: Checked without journallock on the fast path (c.f., journal_append),
+	//       so, only ever set via __atomic builtins.
+	int           fd;
+} EventJournal;
+EventJournal    eventJournal = { .fd = -1 };
+// NOTE: Records can be appended from the reaper threads, too.
+//       Never log with it held, as the logger might need it (c.f., log_thread).
+pthread_mutex_t journallock  = PTHREAD_MUTEX_INITIALIZER;
+static int      journal_start_file(off_t*);
+static void     journal_open(void);
+static void     journal_close(void);
+static void     journal_flush_locked(void);
+static void     journal_flush(void);
+static void     journal_append(JournalRecord*, const char*);
+static void     journal_blocked(uint8_t, const char*);
+
+// Runtime metrics (c.f., the stats IPC command)
+// Latencies are tracked in log2 histograms, in µs: bucket n counts samples <= 2^n µs,
+// except for the final one, which catches everything else (i.e., > ~4s).
+#define STATS_BUCKETS 23U
+typedef enum
+{
+	LATENCY_DECISION = 0U,    // From reading an inotify event to deciding what to do about it
+	LATENCY_SQL,              // SQLite lookup of the target icon
+	LATENCY_THUMBNAILS,       // Thumbnail probes
+	LATENCY_EXEC,             // From fork to the execvp verdict
+	LATENCY_MAX
+} LatencyKind;
+typedef struct
+{
+	uint64_t buckets[STATS_BUCKETS];
+	uint64_t count;
+	uint64_t sum_us;
+} LatencyHistogram;
+typedef struct
+{
+	uint64_t         inotify_open;
+	uint64_t         inotify_close;
+	uint64_t         inotify_unmount;
+	uint64_t         inotify_ignored;
+	uint64_t         inotify_overflow;
+	uint64_t         db_checks;
+	// Checks we could skip because we already knew the icon was pending processing
+	uint64_t         db_checks_skipped;
+	uint64_t         db_errors;
+	uint64_t         spawns;
+	uint64_t         exec_failures;
+	uint64_t         blocked_triggers;
+	uint64_t         queued_triggers;
+	uint64_t         dropped_triggers;
+	uint64_t         watchdog_kills;
+	uint64_t         ipc_connections;
+	uint64_t         ipc_commands;
+	uint64_t         ipc_errors;
+	uint64_t         ipc_dropped;
+	LatencyHistogram latency[LATENCY_MAX];
+	// CPU time used by reaper threads that are already gone, in µs
+	// NOTE: That's the only field touched by the reaper threads, it's protected by ptlock.
+	uint64_t         reapers_cpu_us;
+} KFMonStats;
+// NOTE: Everything else is only ever touched by the main thread.
+KFMonStats         kfStats = { 0 };
+static void        stats_mark(struct timespec* restrict);
+static void        stats_observe(LatencyKind, const struct timespec* restrict);
+static uint64_t    get_thread_cpu_us(clockid_t);
+static const char* latency_kind_to_str(LatencyKind) __attribute__((const));
+static int         stats_dump(void);
+
 static bool is_target_mounted(void);
 static void wait_for_target_mountpoint(void);
 
@@ -304,7 +705,92 @@ static bool   validate_and_merge_watch_config(void*, uint8_t, bool*);
 static int8_t get_next_available_watch_entry(void);
 static int    fts_alphasort(const FTSENT**, const FTSENT**);
 static int    load_config(void);
+static bool   is_watch_config_name(const char*);
+static void   release_watch(uint8_t);
+static void   notify_watch_update(void);
+static int8_t check_watch_config_file(const char*, const char*, const struct stat*, bool*, bool*);
+static void   add_target_watch(int, uint8_t);
 static int    update_watch_configs(void);
+// Our inotify watch on the config directory (c.f., handle_config_event)
+int           configDirWd = -1;
+static void   handle_config_event(int, const struct inotify_event*);
+static int    drop_gone_configs(int);
+
+// Fingerprint of a watch config file, so that update_watch_configs only has to parse & merge the ones that changed.
+// NOTE: Broken configs need one, too, hence the extra room.
+#define CONFIG_FILES_MAX   (WATCH_MAX * 2)
+// Watch configs are tiny, don't bother fingerprinting anything larger than that
+#define CONFIG_FILE_SZ_MAX (64 * 1024)
+// A file whose mtime is within that many seconds of our last check could have changed without its mtime moving,
+// (vfat only has a 2s granularity), so we'll have to compare its contents to be sure (c.f., git's "racy clean" entries).
+#define CONFIG_MTIME_SLOP  2
+// Editors that save by renaming the original away (or by deleting it) write it back right after,
+// so a watch config has to stay gone for that long (in ms) before we drop its watch (c.f., drop_gone_configs).
+#define CONFIG_GONE_DELAY  1500
+typedef struct
+{
+	char            name[NAME_MAX + 1];
+	ino_t           ino;
+	off_t           size;
+	struct timespec mtime;
+	// FNV-1a hash of its contents
+	uint64_t        hash;
+	// When we last hashed it (0 forces a re-check)
+	time_t          checked_at;
+	// The watch slot it backs, or -1
+	int8_t          watch_idx;
+	// Failed to parse, no sense in trying again until it changes
+	bool            is_broken;
+	bool            is_seen;
+	// It went away, and its watch will be dropped after gone_deadline unless it comes back
+	bool            is_gone;
+	struct timespec gone_deadline;
+} ConfigFingerprint;
+ConfigFingerprint         configFingerprints[CONFIG_FILES_MAX] = { 0 };
+static uint64_t           fnv1a_update(uint64_t, const void*, size_t) __attribute__((pure));
+static uint64_t           fnv1a_hash(const char*, size_t) __attribute__((pure));
+static ConfigFingerprint* get_config_fingerprint(const char*);
+static void               forget_config_fingerprints(uint8_t);
+static bool               is_config_unchanged(const ConfigFingerprint*, const struct stat*);
+static char*              read_config_file(const char*, struct stat*, uint64_t*);
+static void               update_config_fingerprint(ConfigFingerprint*, const struct stat*, uint64_t, int8_t, bool);
+
+// Compact binary snapshot of our whole config, stored on the rootfs, so that we don't have to wait for onboard,
+// or walk & parse every config file on startup if nothing changed since last time.
+// NOTE: It's only ever read back by the exact same build, so it's simply a dump of our own structs.
+#define CONFIG_SNAPSHOT_MAGIC   0x434D464BU    // "KFMC"
+#define CONFIG_SNAPSHOT_VERSION 3U
+typedef struct
+{
+	uint32_t          magic;
+	uint32_t          format;
+	uint32_t          size;
+	char              version[64];
+	// c.f., get_config_dir_hash
+	uint64_t          dir_hash;
+	// c.f., get_daemon_config_hash (as of when daemon was actually parsed)
+	uint64_t          daemon_hash;
+	// FNV-1a of everything below
+	uint64_t          checksum;
+	DaemonConfig      daemon;
+	WatchConfig       watches[WATCH_MAX];
+	ConfigFingerprint files[CONFIG_FILES_MAX];
+} ConfigSnapshot;
+// The dir_hash of our current snapshot
+uint64_t    configSnapshotHash  = 0U;
+// The get_daemon_config_hash of the files our current daemonConfig was parsed from
+uint64_t    daemonConfigHash    = 0U;
+// We started from our snapshot before the target was mounted, and have yet to check that it's still accurate
+bool        isConfigProvisional = false;
+// Our current config can't be snapshotted (c.f., reload_daemon_config)
+bool        isSnapshotInhibited = false;
+static int  get_config_dir_hash(uint64_t*);
+static int  get_daemon_config_hash(uint64_t*);
+static int  load_config_snapshot(bool);
+static void save_config_snapshot(void);
+static void reload_daemon_config(void);
+static void refresh_daemon_config(void);
+static void revalidate_config(void);
 // Make our config global, because I'm terrible at C.
 DaemonConfig  daemonConfig           = { 0 };
 WatchConfig   watchConfig[WATCH_MAX] = { 0 };
@@ -313,39 +799,50 @@ FBInkState    fbinkState             = { 0 };
 bool          need_pen_mode          = false;
 uint8_t       fwVersion              = 0U;
 
+// Identical consecutive notifications are only shown once every FB_REPEAT_WINDOW seconds (c.f., fb_should_print),
+// so that bursts of events (e.g., during Nickel's startup) don't keep repainting the same thing on screen.
+#define FB_REPEAT_WINDOW 5
+#define FB_MSG_MAX       256U
+typedef struct
+{
+	struct timespec ts;
+	unsigned int    hash;
+} FBRepeat;
+FBRepeat fbRepeat = { 0 };
+
+// We keep a single fb fd open for our whole lifetime, and bracket bursts of notifications in a single pen mode toggle
+typedef struct
+{
+	int          fd;
+	unsigned int batch_depth;
+	bool         is_pen_mode;
+} FBHandle;
+FBHandle        fbHandle = { .fd = -1 };
+// NOTE: Notifications can come from the reaper threads, too.
+pthread_mutex_t fblock   = PTHREAD_MUTEX_INITIALIZER;
+static bool     fb_should_print(const char*);
+static void     fb_leave_pen_mode(void);
+static void     fb_print(const char*);
+static void     fb_begin_batch(void);
+static void     fb_end_batch(void);
+static void     fb_reinit(void);
+static void     fb_cleanup(void);
+
 // NOTE: Unless we're able to tell FBInk to follow the wb's rotation (i.e., with fbdamage's help),
 //       we want to bracket our refreshes in "pen" mode on older sunxi kernels (c.f., FBInk/#64 for more details),
-//       so handle the switcheroo in a macro to avoid code duplication...
+//       fb_print takes care of the switcheroo (once per batch, c.f., fb_begin_batch).
 #define FB_PRINT(msg)                                                                                                    \
 	({                                                                                                               \
-		if (need_pen_mode) {                                                                                     \
-			int fbfd = fbink_open();                                                                         \
-			fbink_sunxi_toggle_ntx_pen_mode(fbfd, true);                                                     \
-                                                                                                                         \
-			fbink_print(fbfd, msg, &fbinkConfig);                                                            \
-                                                                                                                         \
-			fbink_sunxi_toggle_ntx_pen_mode(fbfd, false);                                                    \
-                                                                                                                         \
-			fbink_close(fbfd);                                                                               \
-		} else {                                                                                                 \
-			fbink_print(FBFD_AUTO, msg, &fbinkConfig);                                                       \
-		}                                                                                                        \
+		CLOG(LOG_CAT_FBINK, LOG_DEBUG, "On screen: %s", msg);                                                    \
+		fb_print(msg);                                                                                           \
 	})
 
+// NOTE: We format it ourselves, as we need the actual message to weed out repeats.
 #define FB_PRINTF(fmt, ...)                                                                                              \
 	({                                                                                                               \
-		if (need_pen_mode) {                                                                                     \
-			int fbfd = fbink_open();                                                                         \
-			fbink_sunxi_toggle_ntx_pen_mode(fbfd, true);                                                     \
-                                                                                                                         \
-			fbink_printf(fbfd, NULL, &fbinkConfig, NULL, fmt, ##__VA_ARGS__);                                \
-                                                                                                                         \
-			fbink_sunxi_toggle_ntx_pen_mode(fbfd, false);                                                    \
-                                                                                                                         \
-			fbink_close(fbfd);                                                                               \
-		} else {                                                                                                 \
-			fbink_printf(FBFD_AUTO, NULL, &fbinkConfig, NULL, fmt, ##__VA_ARGS__);                           \
-		}                                                                                                        \
+		char fb_msg_[FB_MSG_MAX];                                                                                \
+		snprintf(fb_msg_, sizeof(fb_msg_), fmt, ##__VA_ARGS__);                                                  \
+		FB_PRINT(fb_msg_);                                                                                       \
 	})
 
 // Cute trick from https://stackoverflow.com/a/7618231
@@ -357,19 +854,108 @@ static bool         check_fw_5x_thumbnails(const char*, size_t);
 static bool         is_target_processed(uint8_t, bool);
 
 static void* reaper_thread(void*);
-static pid_t spawn(char* const*, uint8_t);
+static pid_t spawn(char* const*, uint8_t, SpawnSource);
 
 static bool  is_watch_already_spawned(uint8_t);
 static bool  is_blocker_running(void);
 static bool  are_spawns_blocked(void);
 static pid_t get_spawn_pid_for_watch(uint8_t);
 
+// IPC clients are handled as non-blocking sessions in the main loop, so that we can serve a few of them concurrently.
+#define IPC_SESSIONS_MAX 8
+// Drop sessions that have been idle for that long (in seconds)
+#define IPC_IDLE_TIMEOUT  60
+// Replies that can't be sent right away are buffered, up to IPC_OUTBUF_MAX bytes,
+// and the client has IPC_WRITE_TIMEOUT seconds to make progress reading them, otherwise it gets dropped.
+#define IPC_OUTBUF_MAX    (64 * 1024)
+#define IPC_WRITE_TIMEOUT 5
+typedef struct
+{
+	// Idle deadline
+	struct timespec deadline;
+	// Deadline for the client to read (some of) its pending replies
+	struct timespec write_deadline;
+	struct ucred    ucred;
+	char*           out_buf;
+	size_t          out_len;
+	size_t          out_cap;
+	// Where a framed (v2) reply is assembled, c.f., handle_framed_command
+	char*           frame_buf;
+	size_t          frame_len;
+	size_t          frame_cap;
+	// Amount of buffered input (e.g., a partial frame, or a partial command following a complete one)
+	size_t          in_len;
+	// -1 means the slot is available
+	int             fd;
+	// Protocol version (1 is the legacy text protocol, c.f., utils/ipc_proto.h)
+	uint8_t         proto;
+	// Id of the (v2) request being processed
+	uint32_t        req_id;
+	// Set while we're waiting on a process to exit to reply to a *-wait command (and req_id, if framed)
+	pid_t           wait_pid;
+	uint32_t        wait_id;
+	bool            is_framing;
+	bool            is_subscribed;
+	// Flagged when we fail to push an event to it, it'll be closed from the main loop
+	bool            is_dead;
+	// Set when in_buf starts with (v1) input left over from a previous read (c.f., handle_text_input)
+	bool            has_leftovers;
+	char            pname[16];
+	char            uname[32];
+	char            gname[32];
+	// Eh, recycle PIPE_BUF, it should be more than enough for our needs.
+	char            in_buf[PIPE_BUF];
+} IpcSession;
+IpcSession ipcSessions[IPC_SESSIONS_MAX];
+
+// Pre-serialized replies for the list & gui-list IPC commands, only rebuilt when the set of watches changes.
+// The generation is bumped on every change, so that clients can cheaply check whether they're up to date.
+// NOTE: It's seeded per process (c.f., main), so that a generation from a previous instance never matches ours.
+// Entries are formatted as id:basename(filename)[:label]\n, and the final NUL is part of the buffer.
+#define WATCH_LIST_SZ (WATCH_MAX * (3U + 1U + CFG_SZ_MAX + 1U + CFG_SZ_MAX + 1U) + 1U)
+typedef struct
+{
+	char     list[WATCH_LIST_SZ];
+	char     gui_list[WATCH_LIST_SZ];
+	size_t   list_len;
+	size_t   gui_list_len;
+	uint32_t generation;
+	bool     is_stale;
+} WatchListCache;
+WatchListCache watchLists = { .generation = 1U, .is_stale = true };
+
 static bool handle_events(int);
-static bool handle_ipc(int);
+static bool handle_ipc(IpcSession*, const char*, size_t);
 static void get_process_name(const pid_t, char*);
 static void get_user_name(const uid_t, char*);
 static void get_group_name(const gid_t, char*);
 static void handle_connection(int);
+static void close_session(IpcSession*);
+static int  queue_reply(IpcSession*, const char*, size_t);
+static int  queue_output(IpcSession*, const char*, size_t);
+static void flush_session_output(IpcSession*);
+static void handle_session_input(IpcSession*);
+static void handle_text_input(IpcSession*, bool);
+static void handle_framed_input(IpcSession*);
+static bool handle_framed_command(IpcSession*, uint32_t, const char*, size_t);
+static int  queue_frame(IpcSession*, uint32_t, IpcFrameKind, const char*, size_t);
+static void complete_exit_waits(void);
+static int  expire_sessions(void);
+static void publish_event(const char*, ...) __attribute__((format(printf, 1, 2)));
+static void publish_watch_event(const char*, uint8_t);
+static void publish_blocked_event(uint8_t, const char*);
+static void publish_exit_events(void);
+static void invalidate_watch_lists(void);
+static void refresh_watch_lists(void);
+
+// Shared memory status page (c.f., utils/status_page.h), NULL if we couldn't set it up.
+// NOTE: Only ever updated by the main thread.
+#if WATCH_MAX != KFMON_STATUS_WATCH_MAX || CFG_SZ_MAX != KFMON_STATUS_SZ_MAX
+#	error "The status page layout doesn't match our limits!"
+#endif
+KFMonStatusPage* statusPage = NULL;
+static void      init_status_page(void);
+static void      update_status_page(void);
 
 static void sql_errorlogcb(void* __attribute__((unused)), int, const char*);
 
@@ -18,6 +18,10 @@ FBINK_BIN="/usr/local/kfmon/bin/fbink"
 KFMON_LOG="/usr/local/kfmon/kfmon.log"
 # Where's our log dump on the userstore?
 KFMON_USER_LOG="/mnt/onboard/.adds/kfmon/log/kfmon_dump.log"
+# Where does KFMon save its in-memory log?
+KFMON_RAM_LOG="/mnt/onboard/.adds/kfmon/log/kfmon_ram.log"
+# Pickup the IPC client we're shipping, to talk to KFMon when it keeps its log in memory
+KFMON_IPC_BIN="/usr/local/kfmon/bin/kfmon-ipc"
 # How many lines do we want to print?
 # NOTE: Start high, we'll try to adjust it down to fit both the screen & the content later...
 LOG_LINES="40"
@@ -26,13 +30,56 @@ export FBINK_FORCE_ROTA="4"
 # If we can't, follow the gyro...
 export FBINK_FORCE_ROTA_FALLBACK="-1"
 
+# Our log is rotated into segments (kfmon.log, then kfmon.log.1, kfmon.log.2, ..., possibly gzipped).
+# Print the requested segment (0 being the current one), if it exists.
+cat_log_segment()
+{
+	if [ "${1}" -eq "0" ] ; then
+		cat "${KFMON_LOG}"
+	elif [ -f "${KFMON_LOG}.${1}.gz" ] ; then
+		zcat "${KFMON_LOG}.${1}.gz"
+	elif [ -f "${KFMON_LOG}.${1}" ] ; then
+		cat "${KFMON_LOG}.${1}"
+	fi
+}
+
+# The tail end of the log, which might straddle the previous segment if we've just rotated
+cat_recent_log()
+{
+	# Just ask KFMon if it's in memory
+	if [ "${KFMON_LOG_TO_RAM}" = "true" ] ; then
+		${KFMON_IPC_BIN} -c "log-dump:${LOG_LINES}" | tr -d '\000'
+		return
+	fi
+
+	if [ "$(wc -l < "${KFMON_LOG}")" -lt "${LOG_LINES}" ] ; then
+		cat_log_segment 1 | tail -n "${LOG_LINES}"
+	fi
+	cat_log_segment 0
+}
+
+# The whole history, oldest first
+cat_full_log()
+{
+	# Ask KFMon to save it if it's in memory
+	if [ "${KFMON_LOG_TO_RAM}" = "true" ] ; then
+		${KFMON_IPC_BIN} -c "log-save" >/dev/null 2>&1
+		cat "${KFMON_RAM_LOG}"
+		return
+	fi
+
+	for segment in 9 8 7 6 5 4 3 2 1 0 ; do
+		cat_log_segment "${segment}"
+	done
+}
+
 # See how many lines we can actually print...
 # shellcheck disable=SC2046
 eval $(${FBINK_BIN} -e)
 # Try to account for linebreaks...
 MAXCHARS="$(awk -v LOG_LINES="${LOG_LINES}" -v MAXCOLS="${MAXCOLS}" -v MAXROWS="${MAXROWS}" 'BEGIN { print int(MAXCOLS * (MAXROWS - (LOG_LINES / 2))) }')"
 
-# Check if we're logging to syslog instead...
+# Check if we're logging to syslog (or to memory) instead...
 KFMON_CFG_FILES="/mnt/onboard/.adds/kfmon/config/kfmon.ini /mnt/onboard/.adds/kfmon/config/kfmon.user.ini"
 for kfmon_cfg in ${KFMON_CFG_FILES} ; do
 	if [ -f "${kfmon_cfg}" ] ; then
@@ -41,6 +88,11 @@ for kfmon_cfg in ${KFMON_CFG_FILES} ; do
 		else
 			KFMON_USE_SYSLOG="false"
 		fi
+		if grep log_to_ram "${kfmon_cfg}" | grep -q -i -e 1 -e "on" -e "true" -e "yes" ; then
+			KFMON_LOG_TO_RAM="true"
+		else
+			KFMON_LOG_TO_RAM="false"
+		fi
 	fi
 done
 
@@ -52,7 +104,7 @@ if [ "${KFMON_USE_SYSLOG}" = "true" ] ; then
 		MAXCHARS="$(awk -v LOG_LINES="${LOG_LINES}" -v MAXCOLS="${MAXCOLS}" -v MAXROWS="${MAXROWS}" 'BEGIN { print int(MAXCOLS * (MAXROWS - (LOG_LINES / 2))) }')"
 	done
 else
-	while [ "$(tail -n ${LOG_LINES} "${KFMON_LOG}" | wc -c)" -gt "${MAXCHARS}" ] ; do
+	while [ "$(cat_recent_log | tail -n ${LOG_LINES} | wc -c)" -gt "${MAXCHARS}" ] ; do
 		LOG_LINES=$(( LOG_LINES - 1 ))
 		# Amount of lines changed, update that!
 		MAXCHARS="$(awk -v LOG_LINES="${LOG_LINES}" -v MAXCOLS="${MAXCOLS}" -v MAXROWS="${MAXROWS}" 'BEGIN { print int(MAXCOLS * (MAXROWS - (LOG_LINES / 2))) }')"
@@ -69,7 +121,7 @@ if [ "${KFMON_USE_SYSLOG}" = "true" ] ; then
 		exit 1
 	fi
 else
-	if [ "${LOG_LINES}" -eq "0" ] || [ "$(tail -n ${LOG_LINES} "${KFMON_LOG}" | wc -c)" -eq "0" ] ; then
+	if [ "${LOG_LINES}" -eq "0" ] || [ "$(cat_recent_log | tail -n ${LOG_LINES} | wc -c)" -eq "0" ] ; then
 		${FBINK_BIN} -q -Mmph "Nothing to print?!"
 		exit 1
 	fi
@@ -79,14 +131,14 @@ fi
 if [ "${KFMON_USE_SYSLOG}" = "true" ] ; then
 	logread | grep -e KFMon -e FBInk | tail -n ${LOG_LINES} | ${FBINK_BIN} -q
 else
-	tail -n ${LOG_LINES} "${KFMON_LOG}" | ${FBINK_BIN} -q
+	cat_recent_log | tail -n ${LOG_LINES} | ${FBINK_BIN} -q
 fi
 
 # Dump it in the userstore, to make it easily accessible to users without shell access
 if [ "${KFMON_USE_SYSLOG}" = "true" ] ; then
 	logread | grep -e KFMon -e FBInk > "${KFMON_USER_LOG}" 2>&1
 else
-	cp -f "${KFMON_LOG}" "${KFMON_USER_LOG}"
+	cat_full_log > "${KFMON_USER_LOG}"
 fi
 # Add a timestamp, and a dump of Nickel's version tag
 echo "**** Log dumped on $(date +'%Y-%m-%d @ %H:%M:%S') ****" >> "${KFMON_USER_LOG}"
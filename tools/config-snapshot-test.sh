@@ -0,0 +1,142 @@
+#!/bin/bash -e
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+# Regression test for the config snapshot: make sure changes to the daemon config (kfmon.ini) are never lost,
+# whether they're made while KFMon is running (and something else in the config directory changes, too),
+# or while it's stopped.
+# Usage: config-snapshot-test.sh <kfmon> <mountpoint>
+# NOTE: The kfmon binary has to be built w/ KFMON_TARGET_MOUNTPOINT set to <mountpoint> (c.f., make snapshot-test).
+#       This needs to run as root, as KFMon only cares about actual mountpoints, so we mount a tmpfs there.
+#       KFMon still uses its usual log, pidfile, IPC socket & snapshot, so, don't run this alongside a live instance.
+#
+##
+
+if [[ $# -lt 2 ]] ; then
+	echo "Usage: ${0} <kfmon> <mountpoint>"
+	exit 1
+fi
+
+KFMON_BIN="$(readlink -f "${1}")"
+TEST_MNT="${2}"
+
+KFMON_PIDFILE="/var/run/kfmon.pid"
+KFMON_IPC_SOCKET="/tmp/kfmon-ipc.ctl"
+KFMON_LOGFILE="/usr/local/kfmon/kfmon.log"
+KFMON_SNAPSHOT="/usr/local/kfmon/kfmon-config.snap"
+KFMON_CONFIG="${TEST_MNT}/.adds/kfmon/config"
+
+if [[ "$(id -u)" -ne 0 ]] ; then
+	echo "This needs to run as root!"
+	exit 1
+fi
+
+if [[ -f "${KFMON_PIDFILE}" ]] && kill -0 "$(cat "${KFMON_PIDFILE}")" 2>/dev/null ; then
+	echo "KFMon is already running, stop it first!"
+	exit 1
+fi
+
+stop_kfmon() {
+	if [[ -f "${KFMON_PIDFILE}" ]] ; then
+		local pid
+		pid="$(cat "${KFMON_PIDFILE}")"
+		kill "${pid}" 2>/dev/null || true
+		for i in $(seq 50) ; do
+			kill -0 "${pid}" 2>/dev/null || break
+			sleep 0.1
+		done
+	fi
+}
+
+start_kfmon() {
+	rm -f "${KFMON_IPC_SOCKET}"
+	"${KFMON_BIN}"
+	for i in $(seq 50) ; do
+		[[ -S "${KFMON_IPC_SOCKET}" ]] && break
+		sleep 0.1
+	done
+	if [[ ! -S "${KFMON_IPC_SOCKET}" ]] ; then
+		echo "KFMon failed to start, check its log!"
+		exit 1
+	fi
+	# Let it settle (and snapshot its config)
+	sleep 1
+}
+
+cleanup() {
+	stop_kfmon
+	umount "${TEST_MNT}" 2>/dev/null || true
+}
+trap cleanup EXIT
+
+# Check which db_timeout KFMon ended up with on its last startup
+expect_db_timeout() {
+	local expected="${1}"
+	local got
+	got="$(tail -c +"$((LOG_OFFSET + 1))" "${KFMON_LOGFILE}" | grep -E "(Config loaded from our snapshot|Daemon config loaded from 'kfmon.ini')" | grep -o 'db_timeout=[0-9]*' | tail -n 1)"
+	if [[ "${got}" != "db_timeout=${expected}" ]] ; then
+		echo "FAIL: ${2}: expected db_timeout=${expected}, got '${got}'"
+		exit 1
+	fi
+	echo "PASS: ${2}"
+}
+
+restart_kfmon() {
+	stop_kfmon
+	LOG_OFFSET="$(stat -c %s "${KFMON_LOGFILE}" 2>/dev/null || echo 0)"
+	start_kfmon
+}
+
+## Fake userstore
+mkdir -p "${TEST_MNT}"
+mountpoint -q "${TEST_MNT}" || mount -t tmpfs kfmon-test "${TEST_MNT}"
+mkdir -p "${KFMON_CONFIG}" "${TEST_MNT}/.adds/kfmon/bin" "${TEST_MNT}/.kobo"
+
+cat > "${KFMON_CONFIG}/kfmon.ini" <<EoF
+[daemon]
+db_timeout = 500
+use_syslog = 0
+with_notifications = 0
+with_storage_notifications = 0
+EoF
+
+printf '#!/bin/sh\nexit 0\n' > "${TEST_MNT}/.adds/kfmon/bin/test.sh"
+chmod a+x "${TEST_MNT}/.adds/kfmon/bin/test.sh"
+touch "${TEST_MNT}/test.png"
+cat > "${KFMON_CONFIG}/test.ini" <<EoF
+[watch]
+filename = ${TEST_MNT}/test.png
+action = ${TEST_MNT}/.adds/kfmon/bin/test.sh
+label = test
+EoF
+
+if command -v sqlite3 >/dev/null 2>&1 ; then
+	sqlite3 "${TEST_MNT}/.kobo/KoboReader.sqlite" \
+		"CREATE TABLE content (ContentID TEXT, ContentType TEXT, ImageID TEXT, Title TEXT, Attribution TEXT, Description TEXT);"
+fi
+
+## Go!
+rm -f "${KFMON_SNAPSHOT}"
+LOG_OFFSET="$(stat -c %s "${KFMON_LOGFILE}" 2>/dev/null || echo 0)"
+start_kfmon
+expect_db_timeout 500 "initial parse"
+
+restart_kfmon
+expect_db_timeout 500 "restart from the snapshot"
+
+# Edit kfmon.ini live, and then poke at a watch config, which triggers a snapshot update
+sed -i 's/^db_timeout = .*/db_timeout = 900/' "${KFMON_CONFIG}/kfmon.ini"
+sleep 0.1
+echo "hidden = 0" >> "${KFMON_CONFIG}/test.ini"
+sleep 1
+restart_kfmon
+expect_db_timeout 900 "kfmon.ini edited while running"
+
+restart_kfmon
+expect_db_timeout 900 "restart after a live edit"
+
+# Edit kfmon.ini behind its back
+stop_kfmon
+sed -i 's/^db_timeout = .*/db_timeout = 1200/' "${KFMON_CONFIG}/kfmon.ini"
+restart_kfmon
+expect_db_timeout 1200 "kfmon.ini edited while stopped"
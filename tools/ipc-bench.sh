@@ -0,0 +1,93 @@
+#!/bin/bash -e
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+# Spin up a throwaway KFMon instance against a fake userstore, and hammer its IPC socket with kfmon-ipc-bench.
+# Usage: ipc-bench.sh <kfmon> <kfmon-ipc-bench> <mountpoint> [kfmon-ipc-bench options...]
+# NOTE: The kfmon binary has to be built w/ KFMON_TARGET_MOUNTPOINT set to <mountpoint> (c.f., make ipc-bench).
+#       This needs to run as root, as KFMon only cares about actual mountpoints, so we mount a tmpfs there.
+#       KFMon still uses its usual log, pidfile & IPC socket, so, don't run this alongside a live instance,
+#       and expect a *lot* of noise in its log.
+#
+##
+
+if [[ $# -lt 3 ]] ; then
+	echo "Usage: ${0} <kfmon> <kfmon-ipc-bench> <mountpoint> [kfmon-ipc-bench options...]"
+	exit 1
+fi
+
+KFMON_BIN="$(readlink -f "${1}")"
+BENCH_BIN="$(readlink -f "${2}")"
+BENCH_MNT="${3}"
+shift 3
+
+KFMON_PIDFILE="/var/run/kfmon.pid"
+KFMON_IPC_SOCKET="/tmp/kfmon-ipc.ctl"
+
+if [[ "$(id -u)" -ne 0 ]] ; then
+	echo "This needs to run as root!"
+	exit 1
+fi
+
+if [[ -f "${KFMON_PIDFILE}" ]] && kill -0 "$(cat "${KFMON_PIDFILE}")" 2>/dev/null ; then
+	echo "KFMon is already running, stop it first!"
+	exit 1
+fi
+
+cleanup() {
+	if [[ -f "${KFMON_PIDFILE}" ]] ; then
+		kill "$(cat "${KFMON_PIDFILE}")" 2>/dev/null || true
+		sleep 1
+	fi
+	umount "${BENCH_MNT}" 2>/dev/null || true
+}
+trap cleanup EXIT
+
+## Fake userstore
+mkdir -p "${BENCH_MNT}"
+mountpoint -q "${BENCH_MNT}" || mount -t tmpfs kfmon-bench "${BENCH_MNT}"
+mkdir -p "${BENCH_MNT}/.adds/kfmon/config" "${BENCH_MNT}/.adds/kfmon/bin" "${BENCH_MNT}/.kobo"
+
+cat > "${BENCH_MNT}/.adds/kfmon/config/kfmon.ini" <<EoF
+[daemon]
+db_timeout = 500
+use_syslog = 0
+with_notifications = 0
+with_storage_notifications = 0
+EoF
+
+# A couple of watches, with actions that don't linger for too long, so that start requests alternate between
+# actual spawns & already running warnings.
+for watch in bench-a bench-b bench-c ; do
+	printf '#!/bin/sh\nsleep 0.25\n' > "${BENCH_MNT}/.adds/kfmon/bin/${watch}.sh"
+	chmod a+x "${BENCH_MNT}/.adds/kfmon/bin/${watch}.sh"
+	touch "${BENCH_MNT}/${watch}.png"
+	cat > "${BENCH_MNT}/.adds/kfmon/config/${watch}.ini" <<EoF
+[watch]
+filename = ${BENCH_MNT}/${watch}.png
+action = ${BENCH_MNT}/.adds/kfmon/bin/${watch}.sh
+label = ${watch}
+EoF
+done
+
+# An empty Nickel DB, which is all KFMon needs to be happy
+if command -v sqlite3 >/dev/null 2>&1 ; then
+	sqlite3 "${BENCH_MNT}/.kobo/KoboReader.sqlite" \
+		"CREATE TABLE content (ContentID TEXT, ContentType TEXT, ImageID TEXT, Title TEXT, Attribution TEXT, Description TEXT);"
+fi
+
+## Go!
+"${KFMON_BIN}"
+# Wait for the IPC socket to show up...
+for i in $(seq 50) ; do
+	[[ -S "${KFMON_IPC_SOCKET}" ]] && break
+	sleep 0.1
+done
+if [[ ! -S "${KFMON_IPC_SOCKET}" ]] ; then
+	echo "KFMon failed to start, check its log!"
+	exit 1
+fi
+# ...and for the initial watch setup to be done.
+sleep 1
+
+"${BENCH_BIN}" -i 0 -w bench-b.png "${@}"
@@ -0,0 +1,65 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Definitions shared between KFMon and its IPC clients for the framed (v2) IPC protocol.
+
+#ifndef __KFMON_IPC_PROTO_H
+#define __KFMON_IPC_PROTO_H
+
+#include <limits.h>
+#include <stdint.h>
+
+// The legacy (v1) protocol is plain text: one command per read, one NUL-terminated reply per command.
+// A client switches its connection to v2 by sending the "proto:2" text command, and waiting for its "OK" reply.
+// From then on, everything is exchanged as frames: a fixed header, followed by len bytes of payload.
+// NOTE: The header is in host byte order, since this is a local socket.
+// Requests carry a single command (w/o a NUL terminator), and an arbitrary id picked by the client.
+// Each request gets exactly one reply, which echoes its id, and carries the same text as a v1 reply (w/o its final NUL).
+// Requests are processed in order, and clients are free to send more before they've read the previous replies.
+#define KFMON_IPC_PROTO_VERSION 2
+
+typedef enum
+{
+	IPC_FRAME_REQUEST = 1U,
+	IPC_FRAME_REPLY,
+	// Unsolicited (c.f., the subscribe command), id is always 0
+	IPC_FRAME_EVENT,
+} IpcFrameKind;
+
+// Parsed from the reply's prefix (OK*, WARN_*, ERR_*), so clients don't have to.
+typedef enum
+{
+	IPC_STATUS_OK = 0U,
+	IPC_STATUS_WARN,
+	IPC_STATUS_ERR,
+} IpcFrameStatus;
+
+typedef struct __attribute__((packed))
+{
+	uint32_t len;
+	uint32_t id;
+	uint8_t  kind;
+	uint8_t  status;
+	uint16_t reserved;
+} IpcFrameHeader;
+
+// Requests (header included) have to fit in PIPE_BUF
+#define KFMON_IPC_REQUEST_MAX (PIPE_BUF - sizeof(IpcFrameHeader))
+
+#endif
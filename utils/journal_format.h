@@ -0,0 +1,110 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Definitions shared between KFMon and kfmon-journal for the binary event journal.
+
+#ifndef __KFMON_JOURNAL_FORMAT_H
+#define __KFMON_JOURNAL_FORMAT_H
+
+#include <stdint.h>
+
+// The journal is a JournalHeader, followed by a stream of fixed-size JournalRecords, appended as they happen.
+// NOTE: Everything is in host byte order, since it's meant to be decoded on the device, or on a LE host.
+//       Decoders should honor record_size, so that new fields can be appended to records w/o breaking them.
+#define KFMON_JOURNAL_MAGIC   "KFMJ"
+#define KFMON_JOURNAL_VERSION 1
+
+typedef struct __attribute__((packed))
+{
+	char     magic[4];
+	uint16_t version;
+	uint16_t record_size;
+	uint8_t  reserved[8];
+} JournalHeader;
+
+typedef enum
+{
+	// KFMon started, payload is session
+	JOURNAL_EV_SESSION = 1U,
+	// Maps a watch idx to the basename of its target file, payload is name.
+	// Emitted before the first record referencing that watch in a session, or after the slot was reused.
+	JOURNAL_EV_WATCH,
+	// A spawn, payload is spawn (code is unused)
+	JOURNAL_EV_SPAWN,
+	// A spawn exited, payload is spawn
+	// (code is the exit code, or the signal number if JOURNAL_FL_SIGNALED, or -1 if JOURNAL_FL_LOST)
+	JOURNAL_EV_EXIT,
+	// A launch request was refused, payload is spawn (code is a JournalBlockReason, pid is unused)
+	JOURNAL_EV_BLOCKED,
+} JournalEventType;
+
+// Matches KFMon's SpawnSource
+typedef enum
+{
+	JOURNAL_SRC_INOTIFY = 0U,
+	JOURNAL_SRC_IPC,
+	JOURNAL_SRC_NONE = 0xFFU,
+} JournalSource;
+
+// NOTE: Matches the reasons reported by KFMon's "blocked" IPC events, in order.
+typedef enum
+{
+	JOURNAL_BLOCK_PROCESSING = 0U,
+	JOURNAL_BLOCK_RUNNING,
+	JOURNAL_BLOCK_BLOCKER,
+	JOURNAL_BLOCK_INHIBITED,
+	JOURNAL_BLOCK_UNKNOWN,
+} JournalBlockReason;
+#define JOURNAL_BLOCK_REASONS { "processing", "running", "blocker", "inhibited", "unknown" }
+
+#define JOURNAL_FL_SIGNALED (1U << 0U)
+// We failed to reap it, code is meaningless
+#define JOURNAL_FL_LOST     (1U << 1U)
+
+#define JOURNAL_NAME_SZ 20U
+typedef struct __attribute__((packed))
+{
+	// CLOCK_BOOTTIME, in ms (i.e., monotonic, but it keeps ticking while suspended)
+	uint64_t ts_ms;
+	uint8_t  type;
+	int8_t   watch_idx;
+	uint8_t  source;
+	uint8_t  flags;
+	union
+	{
+		struct __attribute__((packed))
+		{
+			// Wall clock time matching ts_ms, in ms since the Epoch
+			int64_t  realtime_ms;
+			uint32_t pid;
+			uint8_t  reserved[8];
+		} session;
+		struct __attribute__((packed))
+		{
+			int32_t  pid;
+			int32_t  code;
+			// How long the spawn ran for (exit only)
+			uint32_t duration_ms;
+			uint8_t  reserved[8];
+		} spawn;
+		char name[JOURNAL_NAME_SZ];
+	};
+} JournalRecord;
+
+#endif
@@ -0,0 +1,679 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Load generator for KFMon's IPC socket.
+// Opens a bunch of concurrent clients that hammer KFMon with a mix of commands (including garbage),
+// some of which read their replies very slowly, or hang up without reading them at all,
+// and reports reply latencies, dropped connections, and how long KFMon's main loop was unresponsive for.
+// NOTE: This is meant to be pointed at a throwaway KFMon instance (c.f., tools/ipc-bench.sh),
+//       as it *will* launch the actions of the watches it's told to start!
+
+// Because we're pretty much Linux-bound ;).
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+// Path to KFMon's IPC Unix socket
+#define KFMON_IPC_SOCKET "/tmp/kfmon-ipc.ctl"
+
+// Clients reconnect after this many requests (except for the ones that hang up, which do so after every request)
+#define REQUESTS_PER_CONNECTION 8U
+// Slow readers pipeline that many requests at once, and then read their replies in SLOW_READ_SZ chunks,
+// every SLOW_READ_INTERVAL ms
+#define SLOW_PIPELINE           32U
+#define SLOW_READ_SZ            64U
+#define SLOW_READ_INTERVAL      20U
+// Back off for that long (ms) before retrying when connect() fails
+#define CONNECT_BACKOFF         10U
+
+typedef enum
+{
+	// Sends a version request every few ms on a single connection, to measure how responsive the main loop is
+	CLIENT_PROBE = 0U,
+	CLIENT_LIST,
+	CLIENT_START,
+	CLIENT_TRIGGER,
+	CLIENT_MALFORMED,
+	CLIENT_SLOW,
+	CLIENT_HANGUP,
+	CLIENT_KINDS,
+} ClientKind;
+
+typedef struct
+{
+	uint32_t* samples;
+	size_t    count;
+	size_t    cap;
+	uint64_t  ok;
+	uint64_t  warn;
+	uint64_t  err;
+	uint64_t  dropped;
+	uint64_t  refused;
+	uint64_t  timeouts;
+	uint64_t  min_ops;
+	uint64_t  max_ops;
+} KindStats;
+
+typedef struct
+{
+	int             fd;
+	ClientKind      kind;
+	bool            is_waiting;
+	// Requests left before we reconnect
+	uint32_t        requests_left;
+	// Replies we're waiting for, and how many we've already got
+	uint32_t        expected;
+	uint32_t        received;
+	// Are we at the start of a reply?
+	bool            is_reply_start;
+	// Worst status seen in the replies to the current batch (0: OK, 1: WARN, 2: ERR)
+	uint8_t         status;
+	// Rotates the command we send
+	uint32_t        seq;
+	uint64_t        ops;
+	struct timespec sent_at;
+	struct timespec next_at;
+} BenchClient;
+
+static const char* const kind_names[CLIENT_KINDS] = {
+	"probe", "list", "start", "trigger", "malformed", "slow-reader", "hangup",
+};
+
+// Every flavor of invalid input we know of
+static const char* const malformed_cmds[] = {
+	"start:",
+	"start:999",
+	"start:-1",
+	"trigger:",
+	"trigger:does-not-exist.png",
+	"nope",
+	"list-if-changed:abc",
+	"trace:maybe",
+	"\x01\x02\x03\xff",
+};
+
+#define MALFORMED_CMDS_COUNT (sizeof(malformed_cmds) / sizeof(*malformed_cmds))
+
+static KindStats kindStats[CLIENT_KINDS];
+
+// CLI options
+static unsigned int client_count   = 16U;
+static unsigned int duration       = 10U;
+static unsigned int timeout_ms     = 5000U;
+static unsigned int probe_interval = 10U;
+static unsigned int stall_ms       = 20U;
+static const char*  watch_id       = "0";
+static const char*  watch_name     = NULL;
+
+static struct sockaddr_un sock_name = { 0 };
+
+static void
+    ts_add_ms(struct timespec* ts, unsigned int ms)
+{
+	ts->tv_sec  += (time_t) (ms / 1000U);
+	ts->tv_nsec += (long) (ms % 1000U) * 1000000L;
+	if (ts->tv_nsec >= 1000000000L) {
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000L;
+	}
+}
+
+// Returns b - a, in µs (clamped to 0)
+static uint64_t
+    ts_diff_us(const struct timespec* a, const struct timespec* b)
+{
+	int64_t us = (int64_t) (b->tv_sec - a->tv_sec) * 1000000LL + (int64_t) (b->tv_nsec - a->tv_nsec) / 1000LL;
+	return us > 0 ? (uint64_t) us : 0U;
+}
+
+static bool
+    ts_is_before(const struct timespec* a, const struct timespec* b)
+{
+	return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+static void
+    record_sample(KindStats* stats, uint64_t us)
+{
+	if (stats->count == stats->cap) {
+		size_t    cap     = stats->cap ? stats->cap * 2U : 1024U;
+		uint32_t* samples = realloc(stats->samples, cap * sizeof(*samples));
+		if (!samples) {
+			fprintf(stderr, "[%s] Aborting: realloc: %m!\n", __PRETTY_FUNCTION__);
+			exit(EXIT_FAILURE);
+		}
+		stats->samples = samples;
+		stats->cap     = cap;
+	}
+	stats->samples[stats->count++] = (uint32_t) (us > UINT32_MAX ? UINT32_MAX : us);
+}
+
+// Close the client's connection, and schedule its next request after delay ms
+static void
+    drop_client(BenchClient* client, const struct timespec* now, unsigned int delay)
+{
+	if (client->fd != -1) {
+		close(client->fd);
+		client->fd = -1;
+	}
+	client->is_waiting = false;
+	client->next_at    = *now;
+	ts_add_ms(&client->next_at, delay);
+}
+
+// Build the next batch of requests for that client, returns the amount of requests in it
+static uint32_t
+    build_request(BenchClient* client, char* buf, size_t size, size_t* len)
+{
+	int      packet_len = 0;
+	uint32_t requests   = 1U;
+	switch (client->kind) {
+		case CLIENT_PROBE:
+			packet_len = snprintf(buf, size, "version");
+			break;
+		case CLIENT_LIST:
+			packet_len = snprintf(buf, size, "%s", (client->seq & 1U) ? "gui-list" : "list");
+			break;
+		case CLIENT_START:
+			packet_len = snprintf(buf, size, "start:%s", watch_id);
+			break;
+		case CLIENT_TRIGGER:
+			packet_len = snprintf(buf, size, "trigger:%s", watch_name);
+			break;
+		case CLIENT_MALFORMED:
+			packet_len = snprintf(buf, size, "%s", malformed_cmds[client->seq % MALFORMED_CMDS_COUNT]);
+			break;
+		case CLIENT_SLOW:
+			// Commands are NUL-separated, so we can send the whole batch in one go
+			for (uint32_t i = 0U; i < SLOW_PIPELINE; i++) {
+				memcpy(buf + packet_len, "gui-list", sizeof("gui-list"));
+				packet_len += (int) sizeof("gui-list");
+			}
+			requests = SLOW_PIPELINE;
+			// Don't send an extra NUL
+			packet_len--;
+			break;
+		case CLIENT_HANGUP:
+			// Make sure KFMon copes with a client going away while it's waiting on a process for it, too
+			if (client->seq & 1U) {
+				packet_len = snprintf(buf, size, "start-wait:%s", watch_id);
+			} else {
+				packet_len = snprintf(buf, size, "list");
+			}
+			break;
+		default:
+			break;
+	}
+	client->seq++;
+
+	// w/ NUL
+	*len = (size_t) packet_len + 1U;
+	return requests;
+}
+
+// Connect if need be, and send the client's next request(s)
+static void
+    start_request(BenchClient* client, const struct timespec* now)
+{
+	KindStats* stats = &kindStats[client->kind];
+
+	if (client->fd == -1) {
+		client->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (client->fd == -1) {
+			fprintf(stderr, "[%s] Aborting: socket: %m!\n", __PRETTY_FUNCTION__);
+			exit(EXIT_FAILURE);
+		}
+
+		while (connect(client->fd, (const struct sockaddr*) &sock_name, sizeof(sock_name)) == -1 &&
+		       errno != EISCONN) {
+			if (errno != EINTR) {
+				// Either the backlog is full (EAGAIN), or KFMon is down
+				stats->refused++;
+				drop_client(client, now, CONNECT_BACKOFF);
+				return;
+			}
+		}
+		client->requests_left = client->kind == CLIENT_HANGUP ? 1U : REQUESTS_PER_CONNECTION;
+	}
+
+	char     buf[PIPE_BUF] = { 0 };
+	size_t   len           = 0U;
+	uint32_t requests      = build_request(client, buf, sizeof(buf), &len);
+
+	ssize_t sent = send(client->fd, buf, len, MSG_NOSIGNAL);
+	if (sent != (ssize_t) len) {
+		// KFMon went away (EPIPE), or isn't draining the socket (EAGAIN)
+		stats->dropped++;
+		drop_client(client, now, CONNECT_BACKOFF);
+		return;
+	}
+
+	if (client->kind == CLIENT_HANGUP) {
+		// We're not going to read the reply, so this one's done as soon as it's sent
+		stats->ok++;
+		client->ops++;
+		drop_client(client, now, 0U);
+		return;
+	}
+
+	client->is_waiting     = true;
+	client->expected       = requests;
+	client->received       = 0U;
+	client->is_reply_start = true;
+	client->status         = 0U;
+	client->sent_at        = *now;
+	client->requests_left--;
+}
+
+// Read whatever's available for that client
+static void
+    handle_client_reply(BenchClient* client, const struct timespec* now)
+{
+	KindStats* stats = &kindStats[client->kind];
+
+	char    buf[PIPE_BUF];
+	size_t  want = client->kind == CLIENT_SLOW ? SLOW_READ_SZ : sizeof(buf);
+	ssize_t len  = recv(client->fd, buf, want, MSG_DONTWAIT);
+	if (len == -1 && (errno == EAGAIN || errno == EINTR)) {
+		return;
+	}
+	if (len <= 0) {
+		// KFMon hung up on us (or reset the connection) before replying
+		stats->dropped++;
+		drop_client(client, now, CONNECT_BACKOFF);
+		return;
+	}
+
+	for (ssize_t i = 0; i < len; i++) {
+		if (client->is_reply_start) {
+			// Good enough, since only WARN_* & ERR_* replies can start with those
+			if (buf[i] == 'E') {
+				client->status = 2U;
+			} else if (buf[i] == 'W' && client->status < 1U) {
+				client->status = 1U;
+			}
+			client->is_reply_start = false;
+		}
+		if (buf[i] == '\0') {
+			client->received++;
+			client->is_reply_start = true;
+		}
+	}
+
+	if (client->kind == CLIENT_SLOW) {
+		client->next_at = *now;
+		ts_add_ms(&client->next_at, SLOW_READ_INTERVAL);
+	}
+
+	if (client->received < client->expected) {
+		return;
+	}
+
+	// We've got every reply we asked for
+	record_sample(stats, ts_diff_us(&client->sent_at, now));
+	if (client->status == 2U) {
+		stats->err++;
+	} else if (client->status == 1U) {
+		stats->warn++;
+	} else {
+		stats->ok++;
+	}
+	client->ops++;
+	client->is_waiting = false;
+
+	client->next_at = *now;
+	if (client->kind == CLIENT_PROBE) {
+		ts_add_ms(&client->next_at, probe_interval);
+	}
+	if (client->requests_left == 0U) {
+		drop_client(client, now, 0U);
+	}
+}
+
+static int
+    compare_samples(const void* a, const void* b)
+{
+	uint32_t x = *(const uint32_t*) a;
+	uint32_t y = *(const uint32_t*) b;
+	return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile, in ms (samples have to be sorted)
+static double
+    percentile(const KindStats* stats, unsigned int p)
+{
+	if (stats->count == 0U) {
+		return 0.0;
+	}
+	size_t rank = (stats->count * p + 99U) / 100U;
+	if (rank > 0U) {
+		rank--;
+	}
+	return (double) stats->samples[rank] / 1000.0;
+}
+
+// Ask KFMon for its own metrics, and print them
+static void
+    print_kfmon_stats(void)
+{
+	int data_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (data_fd == -1) {
+		fprintf(stderr, "[%s] Aborting: socket: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+
+	if (connect(data_fd, (const struct sockaddr*) &sock_name, sizeof(sock_name)) == -1) {
+		fprintf(stderr, "Couldn't connect to KFMon to query its stats (connect: %m)!\n");
+		close(data_fd);
+		return;
+	}
+	// Don't hang forever if it's wedged
+	struct timeval tv = { .tv_sec = (time_t) (timeout_ms / 1000U), .tv_usec = (timeout_ms % 1000U) * 1000 };
+	setsockopt(data_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	if (send(data_fd, "stats", sizeof("stats"), MSG_NOSIGNAL) != (ssize_t) sizeof("stats")) {
+		fprintf(stderr, "Couldn't query KFMon's stats (send: %m)!\n");
+		close(data_fd);
+		return;
+	}
+
+	printf("\nKFMon's own view:\n");
+	char    buf[PIPE_BUF];
+	ssize_t len;
+	while ((len = recv(data_fd, buf, sizeof(buf), 0)) > 0) {
+		void* eor = memchr(buf, '\0', (size_t) len);
+		if (eor) {
+			printf("%.*s", (int) ((char*) eor - buf), buf);
+			break;
+		}
+		printf("%.*s", (int) len, buf);
+	}
+	close(data_fd);
+}
+
+static void
+    print_report(const BenchClient* clients)
+{
+	for (unsigned int i = 0U; i < client_count; i++) {
+		KindStats* stats = &kindStats[clients[i].kind];
+		if (stats->min_ops == 0U || clients[i].ops < stats->min_ops) {
+			stats->min_ops = clients[i].ops;
+		}
+		if (clients[i].ops > stats->max_ops) {
+			stats->max_ops = clients[i].ops;
+		}
+	}
+
+	printf("%u clients for %us\n\n", client_count, duration);
+	printf("%-12s %8s %8s %8s %8s %8s %8s %8s %9s %9s %9s %9s %13s\n",
+	       "kind",
+	       "ops",
+	       "ok",
+	       "warn",
+	       "err",
+	       "dropped",
+	       "refused",
+	       "timeout",
+	       "p50 (ms)",
+	       "p90 (ms)",
+	       "p99 (ms)",
+	       "max (ms)",
+	       "ops/client");
+	for (ClientKind kind = CLIENT_PROBE; kind < CLIENT_KINDS; kind++) {
+		KindStats* stats = &kindStats[kind];
+		if (stats->max_ops == 0U && stats->dropped == 0U && stats->refused == 0U && stats->timeouts == 0U) {
+			continue;
+		}
+		qsort(stats->samples, stats->count, sizeof(*stats->samples), compare_samples);
+		printf("%-12s %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64
+		       " %9.2f %9.2f %9.2f %9.2f %6" PRIu64 "-%-6" PRIu64 "\n",
+		       kind_names[kind],
+		       stats->ok + stats->warn + stats->err,
+		       stats->ok,
+		       stats->warn,
+		       stats->err,
+		       stats->dropped,
+		       stats->refused,
+		       stats->timeouts,
+		       percentile(stats, 50U),
+		       percentile(stats, 90U),
+		       percentile(stats, 99U),
+		       percentile(stats, 100U),
+		       stats->min_ops,
+		       stats->max_ops);
+	}
+
+	// The probe's requests are trivial, so any significant delay in their replies is time spent stuck elsewhere.
+	const KindStats* probe       = &kindStats[CLIENT_PROBE];
+	uint64_t         stalls      = 0U;
+	uint64_t         stall_total = 0U;
+	for (size_t i = 0U; i < probe->count; i++) {
+		if (probe->samples[i] >= stall_ms * 1000U) {
+			stalls++;
+			stall_total += probe->samples[i];
+		}
+	}
+	printf("\nMain loop stalls (probe replies >= %u ms): %" PRIu64 ", for a total of %.2f ms (worst: %.2f ms)\n",
+	       stall_ms,
+	       stalls,
+	       (double) stall_total / 1000.0,
+	       percentile(probe, 100U));
+
+	uint64_t dropped = 0U;
+	for (ClientKind kind = CLIENT_PROBE; kind < CLIENT_KINDS; kind++) {
+		dropped += kindStats[kind].dropped + kindStats[kind].timeouts;
+	}
+	printf("Dropped connections: %" PRIu64 "\n", dropped);
+}
+
+static void
+    show_helpmsg(const char* name)
+{
+	fprintf(stderr,
+		"Usage: %s [-c clients] [-d seconds] [-i watch_id] [-w watch_name] [-t timeout_ms] [-p probe_ms]"
+		" [-s stall_ms]\n"
+		"\n"
+		"  -c  Amount of concurrent clients (default: 16)\n"
+		"  -d  Duration of the run, in seconds (default: 10)\n"
+		"  -i  Watch id used by the start commands (default: 0)\n"
+		"  -w  Watch name used by the trigger commands (default: none, which disables the trigger clients)\n"
+		"  -t  Time after which a pending request is considered lost, in ms (default: 5000)\n"
+		"  -p  Interval between two main loop probes, in ms (default: 10)\n"
+		"  -s  Probe latency above which we consider the main loop stalled, in ms (default: 20)\n",
+		name);
+}
+
+static unsigned int
+    parse_uint(const char* arg, const char* name)
+{
+	char*         end = NULL;
+	unsigned long val = strtoul(arg, &end, 10);
+	if (!*arg || *end || val == 0U || val > UINT_MAX / 1000U) {
+		fprintf(stderr, "Invalid value '%s' for %s!\n", arg, name);
+		exit(EXIT_FAILURE);
+	}
+	return (unsigned int) val;
+}
+
+int
+    main(int argc, char* argv[])
+{
+	int opt;
+	while ((opt = getopt(argc, argv, "c:d:i:w:t:p:s:h")) != -1) {
+		switch (opt) {
+			case 'c':
+				client_count = parse_uint(optarg, "the amount of clients");
+				break;
+			case 'd':
+				duration = parse_uint(optarg, "the duration");
+				break;
+			case 'i':
+				watch_id = optarg;
+				break;
+			case 'w':
+				watch_name = optarg;
+				break;
+			case 't':
+				timeout_ms = parse_uint(optarg, "the timeout");
+				break;
+			case 'p':
+				probe_interval = parse_uint(optarg, "the probe interval");
+				break;
+			case 's':
+				stall_ms = parse_uint(optarg, "the stall threshold");
+				break;
+			case 'h':
+				show_helpmsg(argv[0]);
+				exit(EXIT_SUCCESS);
+			default:
+				show_helpmsg(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+	if (client_count < 2U) {
+		fprintf(stderr, "We need at least two clients (one of which is the main loop probe)!\n");
+		exit(EXIT_FAILURE);
+	}
+
+	sock_name.sun_family = AF_UNIX;
+	memcpy(sock_name.sun_path, KFMON_IPC_SOCKET, sizeof(KFMON_IPC_SOCKET));
+
+	BenchClient*   clients = calloc(client_count, sizeof(*clients));
+	struct pollfd* pfds    = calloc(client_count, sizeof(*pfds));
+	if (!clients || !pfds) {
+		fprintf(stderr, "[%s] Aborting: calloc: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	struct timespec end = now;
+	ts_add_ms(&end, duration * 1000U);
+
+	// The probe goes first, so that it gets a session before everybody else piles up in the backlog.
+	// The others cycle through the remaining kinds (skipping the triggers if we weren't given a watch name).
+	ClientKind kind = CLIENT_LIST;
+	for (unsigned int i = 0U; i < client_count; i++) {
+		clients[i].fd      = -1;
+		clients[i].next_at = now;
+		if (i == 0U) {
+			clients[i].kind = CLIENT_PROBE;
+			continue;
+		}
+		if (kind == CLIENT_TRIGGER && !watch_name) {
+			kind++;
+		}
+		clients[i].kind = kind;
+		kind            = kind + 1U == CLIENT_KINDS ? CLIENT_LIST : kind + 1U;
+	}
+
+	while (ts_is_before(&now, &end)) {
+		// Kick off whatever's due, and figure out how long we can sleep for
+		struct timespec wake_at = end;
+		nfds_t          nfds    = 0U;
+		for (unsigned int i = 0U; i < client_count; i++) {
+			BenchClient* client = &clients[i];
+
+			if (!client->is_waiting && !ts_is_before(&now, &client->next_at)) {
+				start_request(client, &now);
+			}
+
+			struct timespec due = client->next_at;
+			if (client->is_waiting) {
+				struct timespec lost_at = client->sent_at;
+				ts_add_ms(&lost_at, timeout_ms);
+				if (!ts_is_before(&now, &lost_at)) {
+					kindStats[client->kind].timeouts++;
+					drop_client(client, &now, 0U);
+					continue;
+				}
+				due = lost_at;
+
+				// Slow readers only poll when it's time for them to read a bit more
+				if (client->kind != CLIENT_SLOW || !ts_is_before(&now, &client->next_at)) {
+					pfds[nfds].fd     = client->fd;
+					pfds[nfds].events = POLLIN;
+					nfds++;
+				} else if (ts_is_before(&client->next_at, &due)) {
+					due = client->next_at;
+				}
+			}
+			if (ts_is_before(&due, &wake_at)) {
+				wake_at = due;
+			}
+		}
+
+		int timeout = ts_is_before(&now, &wake_at) ? (int) ((ts_diff_us(&now, &wake_at) + 999U) / 1000U) : 0;
+		int poll_num = poll(pfds, nfds, timeout);
+		if (poll_num == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fprintf(stderr, "[%s] Aborting: poll: %m!\n", __PRETTY_FUNCTION__);
+			exit(EXIT_FAILURE);
+		}
+		clock_gettime(CLOCK_MONOTONIC, &now);
+
+		if (poll_num > 0) {
+			for (nfds_t n = 0U; n < nfds; n++) {
+				if (!pfds[n].revents) {
+					continue;
+				}
+				for (unsigned int i = 0U; i < client_count; i++) {
+					if (clients[i].fd == pfds[n].fd && clients[i].is_waiting) {
+						handle_client_reply(&clients[i], &now);
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	// Requests still in flight at this point are simply discarded
+	for (unsigned int i = 0U; i < client_count; i++) {
+		if (clients[i].fd != -1) {
+			close(clients[i].fd);
+		}
+	}
+
+	print_report(clients);
+	print_kfmon_stats();
+
+	for (ClientKind k = CLIENT_PROBE; k < CLIENT_KINDS; k++) {
+		free(kindStats[k].samples);
+	}
+	free(pfds);
+	free(clients);
+
+	return EXIT_SUCCESS;
+}
@@ -20,6 +20,8 @@
 // Small client that sends stdin to the KFMon IPC socket and prints the replies.
 // Replies are always sent to stdout, stderr is used for errors and 'UI'
 // (i.e., in a script, you'll generally want to discard stderr).
+// Alternatively, commands can be passed with -c, in which case we send them all at once,
+// print their full replies, and exit with a status code matching the worst of them (c.f., show_helpmsg).
 
 // Because we're pretty much Linux-bound ;).
 #ifndef _GNU_SOURCE
@@ -28,19 +30,28 @@
 
 #include "../openssh/atomicio.h"
 #include "../str5/str5.h"
+#include "ipc_proto.h"
 #include <errno.h>
 #include <linux/limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 // Path to KFMon's IPC Unix socket
 #define KFMON_IPC_SOCKET "/tmp/kfmon-ipc.ctl"
 
+// Exit codes in batch mode, matching the status of the worst reply
+#define BATCH_RC_OK   EXIT_SUCCESS
+#define BATCH_RC_WARN 2
+#define BATCH_RC_ERR  3
+
 // Drain stdin and send it to the IPC socket (caller aborts on false)
 static bool
     handle_stdin(int data_fd)
@@ -139,6 +150,192 @@ static bool
 	return true;
 }
 
+// Send every command as a v2 frame, and print their replies as they come (c.f., ipc_proto.h)
+// Returns the exit code we should abort with
+static int
+    handle_batch(int data_fd, char* const* cmds, uint32_t cmd_count, int timeout)
+{
+	// Switch the connection to the framed protocol, and pipeline every request right behind that.
+	char   proto_cmd[16] = { 0 };
+	int    proto_len     = snprintf(proto_cmd, sizeof(proto_cmd), "proto:%d", KFMON_IPC_PROTO_VERSION);
+	// w/ NUL
+	size_t packet_len    = (size_t) proto_len + 1U;
+	for (uint32_t i = 0U; i < cmd_count; i++) {
+		size_t len = strlen(cmds[i]);
+		if (len == 0U || len > KFMON_IPC_REQUEST_MAX) {
+			fprintf(stderr,
+				"Command #%u is either empty or too long (max: %zu bytes)!\n",
+				i + 1U,
+				KFMON_IPC_REQUEST_MAX);
+			return EXIT_FAILURE;
+		}
+		packet_len += sizeof(IpcFrameHeader) + len;
+	}
+
+	char* packet = malloc(packet_len);
+	if (!packet) {
+		fprintf(stderr, "[%s] Aborting: malloc: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+	memcpy(packet, proto_cmd, (size_t) proto_len + 1U);
+	size_t offset = (size_t) proto_len + 1U;
+	for (uint32_t i = 0U; i < cmd_count; i++) {
+		// Ids simply match the command's position on the command line
+		IpcFrameHeader hdr = { 0 };
+		hdr.len            = (uint32_t) strlen(cmds[i]);
+		hdr.id             = i + 1U;
+		hdr.kind           = IPC_FRAME_REQUEST;
+		memcpy(packet + offset, &hdr, sizeof(hdr));
+		offset += sizeof(hdr);
+		memcpy(packet + offset, cmds[i], hdr.len);
+		offset += hdr.len;
+	}
+
+	// Do it, being careful to handle EPIPE sanely
+	if (send_in_full(data_fd, packet, packet_len) < 0) {
+		free(packet);
+		if (errno == EPIPE) {
+			fprintf(stderr, "KFMon closed the connection!\n");
+			return EPIPE;
+		}
+		fprintf(stderr, "[%s] Aborting: send: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+	free(packet);
+
+	struct timespec deadline = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec  += timeout / 1000;
+	deadline.tv_nsec += (timeout % 1000) * 1000000L;
+
+	// Replies can be much larger than a request, so this one grows as needed
+	size_t buf_cap = PIPE_BUF;
+	size_t buf_len = 0U;
+	char*  buf     = malloc(buf_cap);
+	if (!buf) {
+		fprintf(stderr, "[%s] Aborting: malloc: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+
+	int           rc          = BATCH_RC_OK;
+	bool          is_switched = false;
+	uint32_t      replies     = 0U;
+	struct pollfd pfd         = { .fd = data_fd, .events = POLLIN };
+	while (replies < cmd_count) {
+		int poll_timeout = -1;
+		if (timeout >= 0) {
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			long long left = (long long) (deadline.tv_sec - now.tv_sec) * 1000LL +
+					 (deadline.tv_nsec - now.tv_nsec) / 1000000L;
+			poll_timeout   = left > 0 ? (int) left : 0;
+		}
+
+		int poll_num = poll(&pfd, 1, poll_timeout);
+		if (poll_num == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fprintf(stderr, "[%s] Aborting: poll: %m!\n", __PRETTY_FUNCTION__);
+			exit(EXIT_FAILURE);
+		}
+		if (poll_num == 0) {
+			fprintf(
+			    stderr, "Timed out waiting for KFMon's replies (got %u out of %u)!\n", replies, cmd_count);
+			rc = ETIMEDOUT;
+			goto cleanup;
+		}
+
+		if (buf_len == buf_cap) {
+			buf_cap *= 2U;
+			char* tmp = realloc(buf, buf_cap);
+			if (!tmp) {
+				fprintf(stderr, "[%s] Aborting: realloc: %m!\n", __PRETTY_FUNCTION__);
+				exit(EXIT_FAILURE);
+			}
+			buf = tmp;
+		}
+
+		ssize_t len = xread(data_fd, buf + buf_len, buf_cap - buf_len);
+		if (len < 0) {
+			// Only actual failures are left, xread handles the rest
+			fprintf(stderr, "[%s] Aborting: read: %m!\n", __PRETTY_FUNCTION__);
+			exit(EXIT_FAILURE);
+		}
+		if (len == 0) {
+			fprintf(stderr, "KFMon closed the connection!\n");
+			rc = EPIPE;
+			goto cleanup;
+		}
+		buf_len += (size_t) len;
+
+		size_t consumed = 0U;
+		// The reply to our protocol switch is the last one in the good old NUL-terminated format
+		if (!is_switched) {
+			const char* eor = memchr(buf, '\0', buf_len);
+			if (!eor) {
+				continue;
+			}
+			if (strncmp(buf, "OK", 2U) != 0) {
+				fprintf(stderr, "KFMon doesn't support framed replies:\n%s", buf);
+				rc = BATCH_RC_ERR;
+				goto cleanup;
+			}
+			is_switched = true;
+			consumed    = (size_t) (eor - buf) + 1U;
+		}
+
+		while (buf_len - consumed >= sizeof(IpcFrameHeader)) {
+			IpcFrameHeader hdr;
+			memcpy(&hdr, buf + consumed, sizeof(hdr));
+			if (buf_len - consumed - sizeof(hdr) < hdr.len) {
+				break;
+			}
+
+			// Events only show up if one of the commands was subscribe, nothing sane we can do with them here.
+			if (hdr.kind == IPC_FRAME_REPLY) {
+				fprintf(stdout, "%.*s", (int) hdr.len, buf + consumed + sizeof(hdr));
+				if (hdr.status == IPC_STATUS_ERR) {
+					rc = BATCH_RC_ERR;
+				} else if (hdr.status == IPC_STATUS_WARN && rc == BATCH_RC_OK) {
+					rc = BATCH_RC_WARN;
+				}
+				replies++;
+			}
+			consumed += sizeof(hdr) + hdr.len;
+		}
+
+		buf_len -= consumed;
+		memmove(buf, buf + consumed, buf_len);
+	}
+
+cleanup:
+	free(buf);
+
+	return rc;
+}
+
+static void
+    show_helpmsg(const char* name)
+{
+	fprintf(stderr,
+		"Usage: %s [-c command [-c command...]] [-t timeout_ms]\n"
+		"\n"
+		"Without any arguments, commands are read from stdin, and replies printed as they come.\n"
+		"\n"
+		"  -c  Send that command, print its reply, and exit.\n"
+		"      Can be repeated, in which case commands are processed in order.\n"
+		"  -t  Give up on KFMon's replies after that many ms, and exit with ETIMEDOUT.\n"
+		"      Defaults to waiting forever.\n"
+		"\n"
+		"When using -c, the exit code is %d if every reply was OK, %d if one of them was a warning,\n"
+		"and %d if one of them was an error.\n",
+		name,
+		BATCH_RC_OK,
+		BATCH_RC_WARN,
+		BATCH_RC_ERR);
+}
+
 // Main entry point
 // NOTE: While I'd ideally want to be able to detect early if KFMon is already busy handling another IPC connection,
 //       the socket's listen backlog is inflated by the kernel, so connect() won't fail w/ EAGAIN any time soon.
@@ -148,8 +345,42 @@ static bool
 //       c.f., utils/sock_utils.h for more details about that conundrum.
 // NOTE: This means, that, yes, KFMon replying to a command is a mandatory part of the "protocol" ;).
 int
-    main(void)
+    main(int argc, char* argv[])
 {
+	// Commands passed via -c, if any
+	char**   cmds      = calloc((size_t) argc, sizeof(*cmds));
+	uint32_t cmd_count = 0U;
+	int      timeout   = -1;
+	if (!cmds) {
+		fprintf(stderr, "[%s] Aborting: calloc: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+
+	int opt;
+	while ((opt = getopt(argc, argv, "c:t:h")) != -1) {
+		switch (opt) {
+			case 'c':
+				cmds[cmd_count++] = optarg;
+				break;
+			case 't': {
+				char* end = NULL;
+				long  val = strtol(optarg, &end, 10);
+				if (!*optarg || *end || val < 0 || val > INT_MAX) {
+					fprintf(stderr, "Invalid timeout: '%s'!\n", optarg);
+					exit(EXIT_FAILURE);
+				}
+				timeout = (int) val;
+				break;
+			}
+			case 'h':
+				show_helpmsg(argv[0]);
+				exit(EXIT_SUCCESS);
+			default:
+				show_helpmsg(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+
 	// Setup the local socket
 	int data_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
 	if (data_fd == -1) {
@@ -172,6 +403,12 @@ int
 	// Assume everything's peachy until shit happens...
 	int rc = EXIT_SUCCESS;
 
+	// No prompt, no chatter, just the replies
+	if (cmd_count > 0U) {
+		rc = handle_batch(data_fd, cmds, cmd_count, timeout);
+		goto cleanup;
+	}
+
 	// Now that KFMon is ready for us, cheap-ass prompt is cheap!
 	fprintf(stderr, ">>> ");
 
@@ -251,6 +488,7 @@ int
 cleanup:
 	// Bye now!
 	close(data_fd);
+	free(cmds);
 
 	return rc;
 }
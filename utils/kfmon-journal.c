@@ -0,0 +1,329 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Decoder for KFMon's binary event journal (c.f., utils/journal_format.h).
+// Renders it as text, or as CSV, for further processing.
+// NOTE: Works just as well on the device as on a (little-endian) host, on a copy of the journal.
+
+// Because we're pretty much Linux-bound ;).
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "journal_format.h"
+
+// Path to KFMon's journal
+#define KFMON_JOURNAL "/usr/local/kfmon/kfmon-journal.bin"
+
+// Watch indices are signed 8-bit values
+#define NAMES_MAX 128U
+
+static bool csv = false;
+
+// Current decoding state (reset for each file)
+typedef struct
+{
+	// Wall clock time (in ms since the Epoch) matching a zero ts_ms, as of the last session record
+	int64_t realtime_offset;
+	bool    has_session;
+	char    names[NAMES_MAX][JOURNAL_NAME_SZ + 1U];
+} DecoderState;
+
+static const char*
+    event_to_str(uint8_t type)
+{
+	switch (type) {
+		case JOURNAL_EV_SESSION:
+			return "session";
+		case JOURNAL_EV_WATCH:
+			return "watch";
+		case JOURNAL_EV_SPAWN:
+			return "spawn";
+		case JOURNAL_EV_EXIT:
+			return "exit";
+		case JOURNAL_EV_BLOCKED:
+			return "blocked";
+		default:
+			return "unknown";
+	}
+}
+
+static const char*
+    source_to_str(uint8_t source)
+{
+	switch (source) {
+		case JOURNAL_SRC_INOTIFY:
+			return "inotify";
+		case JOURNAL_SRC_IPC:
+			return "ipc";
+		default:
+			return "";
+	}
+}
+
+static const char*
+    reason_to_str(int32_t code)
+{
+	static const char* const reasons[] = JOURNAL_BLOCK_REASONS;
+
+	if (code < 0 || code > JOURNAL_BLOCK_UNKNOWN) {
+		code = JOURNAL_BLOCK_UNKNOWN;
+	}
+	return reasons[code];
+}
+
+// Format the wall clock time of a record, if we know it (otherwise, it's just the time since boot)
+static void
+    format_time(const DecoderState* state, const JournalRecord* record, char* buf, size_t size)
+{
+	if (!state->has_session) {
+		snprintf(buf, size, "+%" PRIu64 "ms", record->ts_ms);
+		return;
+	}
+
+	int64_t   realtime_ms = state->realtime_offset + (int64_t) record->ts_ms;
+	time_t    t           = (time_t) (realtime_ms / 1000);
+	struct tm lt;
+	localtime_r(&t, &lt);
+	size_t len = strftime(buf, size, csv ? "%Y-%m-%d %H:%M:%S" : "%Y-%m-%d @ %H:%M:%S", &lt);
+	snprintf(buf + len, size - len, ".%03d", (int) (realtime_ms % 1000));
+}
+
+static void
+    print_record(DecoderState* state, const JournalRecord* record)
+{
+	// Keep track of the metadata records
+	if (record->type == JOURNAL_EV_SESSION) {
+		state->realtime_offset = record->session.realtime_ms - (int64_t) record->ts_ms;
+		state->has_session     = true;
+		// Indices may have been reshuffled since the previous session
+		memset(state->names, 0, sizeof(state->names));
+	} else if (record->type == JOURNAL_EV_WATCH) {
+		if (record->watch_idx >= 0) {
+			memcpy(state->names[record->watch_idx], record->name, JOURNAL_NAME_SZ);
+		}
+		return;
+	}
+
+	char ts[64];
+	format_time(state, record, ts, sizeof(ts));
+	const char* name = record->watch_idx >= 0 ? state->names[record->watch_idx] : "";
+
+	if (csv) {
+		switch (record->type) {
+			case JOURNAL_EV_SESSION:
+				printf("%s,%" PRIu64 ",session,,,%" PRIu32 ",,,\n", ts, record->ts_ms, record->session.pid);
+				break;
+			case JOURNAL_EV_BLOCKED:
+				printf("%s,%" PRIu64 ",blocked,%hhd,%s,,,%s,\n",
+				       ts,
+				       record->ts_ms,
+				       record->watch_idx,
+				       name,
+				       reason_to_str(record->spawn.code));
+				break;
+			default:
+				printf("%s,%" PRIu64 ",%s,%hhd,%s,%" PRId32 ",%s,",
+				       ts,
+				       record->ts_ms,
+				       event_to_str(record->type),
+				       record->watch_idx,
+				       name,
+				       record->spawn.pid,
+				       source_to_str(record->source));
+				if (record->type == JOURNAL_EV_EXIT && record->flags & JOURNAL_FL_LOST) {
+					printf("lost,%" PRIu32 "\n", record->spawn.duration_ms);
+				} else if (record->type == JOURNAL_EV_EXIT) {
+					printf("%s%" PRId32 ",%" PRIu32 "\n",
+					       record->flags & JOURNAL_FL_SIGNALED ? "signal " : "",
+					       record->spawn.code,
+					       record->spawn.duration_ms);
+				} else {
+					printf(",\n");
+				}
+				break;
+		}
+		return;
+	}
+
+	switch (record->type) {
+		case JOURNAL_EV_SESSION:
+			printf("[%s] KFMon started (PID: %" PRIu32 ")\n", ts, record->session.pid);
+			break;
+		case JOURNAL_EV_SPAWN:
+			printf("[%s] Spawned %s (watch idx %hhd) via %s (PID: %" PRId32 ")\n",
+			       ts,
+			       *name ? name : "?",
+			       record->watch_idx,
+			       source_to_str(record->source),
+			       record->spawn.pid);
+			break;
+		case JOURNAL_EV_EXIT:
+			if (record->flags & JOURNAL_FL_LOST) {
+				printf("[%s] Spawn for %s (watch idx %hhd, PID: %" PRId32 ") could not be reaped after %" PRIu32
+				       ".%03" PRIu32 "s\n",
+				       ts,
+				       *name ? name : "?",
+				       record->watch_idx,
+				       record->spawn.pid,
+				       record->spawn.duration_ms / 1000U,
+				       record->spawn.duration_ms % 1000U);
+				break;
+			}
+			printf("[%s] Spawn for %s (watch idx %hhd, PID: %" PRId32 ") %s %" PRId32 " after %" PRIu32
+			       ".%03" PRIu32 "s\n",
+			       ts,
+			       *name ? name : "?",
+			       record->watch_idx,
+			       record->spawn.pid,
+			       record->flags & JOURNAL_FL_SIGNALED ? "was killed by signal" : "exited with status",
+			       record->spawn.code,
+			       record->spawn.duration_ms / 1000U,
+			       record->spawn.duration_ms % 1000U);
+			break;
+		case JOURNAL_EV_BLOCKED:
+			printf("[%s] Refused to spawn %s (watch idx %hhd): %s\n",
+			       ts,
+			       *name ? name : "?",
+			       record->watch_idx,
+			       reason_to_str(record->spawn.code));
+			break;
+		default:
+			printf("[%s] Unknown event type %hhu\n", ts, record->type);
+			break;
+	}
+}
+
+static int
+    decode_file(const char* path)
+{
+	FILE* f = fopen(path, "rbe");
+	if (!f) {
+		fprintf(stderr, "Failed to open '%s': %m!\n", path);
+		return -1;
+	}
+
+	JournalHeader header = { 0 };
+	if (fread(&header, sizeof(header), 1U, f) != 1U ||
+	    memcmp(header.magic, KFMON_JOURNAL_MAGIC, sizeof(header.magic)) != 0) {
+		fprintf(stderr, "'%s' is not a KFMon journal!\n", path);
+		fclose(f);
+		return -1;
+	}
+	// Newer versions may only ever append fields to records, so, we can still make sense of those.
+	if (header.version != KFMON_JOURNAL_VERSION || header.record_size < sizeof(JournalRecord)) {
+		if (header.record_size < sizeof(JournalRecord)) {
+			fprintf(stderr,
+				"'%s' uses an unsupported journal format (version %" PRIu16 ", %" PRIu16 " bytes records)!\n",
+				path,
+				header.version,
+				header.record_size);
+			fclose(f);
+			return -1;
+		}
+		fprintf(stderr, "Decoding '%s' as a version %d journal, but it's a version %" PRIu16 " one\n",
+			path,
+			KFMON_JOURNAL_VERSION,
+			header.version);
+	}
+
+	DecoderState*  state = calloc(1U, sizeof(*state));
+	unsigned char* buf   = malloc(header.record_size);
+	if (!state || !buf) {
+		fprintf(stderr, "[%s] Aborting: malloc: %m!\n", __PRETTY_FUNCTION__);
+		exit(EXIT_FAILURE);
+	}
+	while (fread(buf, header.record_size, 1U, f) == 1U) {
+		JournalRecord record;
+		memcpy(&record, buf, sizeof(record));
+		print_record(state, &record);
+	}
+	// A truncated trailing record is expected if we were interrupted mid-write, just ignore it.
+	free(buf);
+	free(state);
+	fclose(f);
+	return EXIT_SUCCESS;
+}
+
+static void
+    show_helpmsg(const char* name)
+{
+	fprintf(stderr,
+		"Usage: %s [-c] [journal...]\n"
+		"\n"
+		"Decodes KFMon's event journal(s) (default: %s), oldest first, as text.\n"
+		"\n"
+		"  -c  Output CSV instead, with the following columns:\n"
+		"      time,boot_ms,event,watch_idx,watch,pid,source,status,duration_ms\n"
+		"      (status is the exit code for exits (or lost, if it couldn't be reaped), the reason for blocked launches,\n"
+		"      and empty otherwise).\n",
+		name,
+		KFMON_JOURNAL);
+}
+
+int
+    main(int argc, char* argv[])
+{
+	int opt;
+	while ((opt = getopt(argc, argv, "ch")) != -1) {
+		switch (opt) {
+			case 'c':
+				csv = true;
+				break;
+			case 'h':
+				show_helpmsg(argv[0]);
+				exit(EXIT_SUCCESS);
+			default:
+				show_helpmsg(argv[0]);
+				exit(EXIT_FAILURE);
+		}
+	}
+
+	if (csv) {
+		printf("time,boot_ms,event,watch_idx,watch,pid,source,status,duration_ms\n");
+	}
+
+	int rv = EXIT_SUCCESS;
+	if (optind >= argc) {
+		// Include the previous file, if there's one
+		if (access(KFMON_JOURNAL ".old", F_OK) == 0 && decode_file(KFMON_JOURNAL ".old") != EXIT_SUCCESS) {
+			rv = EXIT_FAILURE;
+		}
+		if (decode_file(KFMON_JOURNAL) != EXIT_SUCCESS) {
+			rv = EXIT_FAILURE;
+		}
+	} else {
+		for (int i = optind; i < argc; i++) {
+			if (decode_file(argv[i]) != EXIT_SUCCESS) {
+				rv = EXIT_FAILURE;
+			}
+		}
+	}
+
+	return rv;
+}
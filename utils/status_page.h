@@ -0,0 +1,108 @@
+/*
+	KFMon: Kobo inotify-based launcher
+	Copyright (C) 2016-2024 NiLuJe <ninuje@gmail.com>
+	SPDX-License-Identifier: GPL-3.0-or-later
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Layout of the shared memory status page KFMon publishes, so that clients can check its state without any IPC.
+
+#ifndef __KFMON_STATUS_PAGE_H
+#define __KFMON_STATUS_PAGE_H
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// Clients simply have to shm_open it read-only, and mmap it with PROT_READ.
+// NOTE: It may outlive KFMon if it dies unexpectedly, check that its pid is still alive if that matters to you.
+#define KFMON_STATUS_PAGE_NAME    "/kfmon-status"
+// Bumped whenever the layout changes in an incompatible way
+#define KFMON_STATUS_PAGE_VERSION 1U
+
+// Matches KFMon's own limits (WATCH_MAX & CFG_SZ_MAX)
+#define KFMON_STATUS_WATCH_MAX 16U
+#define KFMON_STATUS_SZ_MAX    128U
+
+typedef struct
+{
+	// 0 if it's not currently running
+	int32_t pid;
+	uint8_t idx;
+	bool    is_hidden;
+	bool    is_blocker;
+	char    name[KFMON_STATUS_SZ_MAX + 1U];
+	char    label[KFMON_STATUS_SZ_MAX + 1U];
+} KFMonStatusWatch;
+
+// The page is updated in place, and protected by a seqlock:
+// seq is odd while an update is in progress, and is bumped again once it's done.
+// Readers should use kfmon_status_page_read, which takes care of the retry dance.
+// NOTE: Updates are tiny, so a reader that keeps losing the race for this long is most likely looking at a page
+//       that KFMon left mid-update (i.e., it died, or was stopped), and should fall back to IPC.
+#define KFMON_STATUS_READ_RETRIES 100U
+typedef struct
+{
+	uint32_t         seq;
+	uint32_t         version;
+	// KFMon's own pid
+	int32_t          pid;
+	// Matches the generation of the list-if-changed IPC command
+	uint32_t         generation;
+	uint8_t          count;
+	// A watch flagged with block_spawns is currently running
+	bool             is_blocker_running;
+	// The BLOCK file was there the last time KFMon checked
+	bool             are_spawns_inhibited;
+	// Active watches, in order
+	KFMonStatusWatch watches[KFMON_STATUS_WATCH_MAX];
+} KFMonStatusPage;
+
+// Take a consistent snapshot of the page.
+// Returns false if its layout doesn't match this version of the header,
+// or if we couldn't get a consistent snapshot after KFMON_STATUS_READ_RETRIES attempts.
+static inline bool
+    kfmon_status_page_read(const KFMonStatusPage* page, KFMonStatusPage* snapshot)
+{
+	for (unsigned int i = 0U; i < KFMON_STATUS_READ_RETRIES; i++) {
+		if (i > 0U) {
+			// Give the writer a chance to finish, backing off a bit more after a while (1ms)
+			if (i < 10U) {
+				sched_yield();
+			} else {
+				const struct timespec backoff = { 0, 1000000L };
+				nanosleep(&backoff, NULL);
+			}
+		}
+
+		uint32_t seq = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1U) {
+			// Writer in progress
+			continue;
+		}
+
+		memcpy(snapshot, page, sizeof(*snapshot));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&page->seq, __ATOMIC_RELAXED) == seq) {
+			return snapshot->version == KFMON_STATUS_PAGE_VERSION;
+		}
+	}
+
+	return false;
+}
+
+#endif